@@ -1,130 +1,140 @@
+// Buffer objects are called directly, libGL exports them on the platforms this
+// builds on.
+#define GL_GLEXT_PROTOTYPES
+
 #include "aeroplane.h"
 
 using namespace GrapheneMath;
 
-// Fills in the m_vertices buffer.
-void AeroplaneRenderModel::GenerateVertices( float scale )
+namespace
 {
-    m_vertices.resize( 0 );
-
-    // Fuselage
-    m_vertices.push_back( ( Vec3 (4.0f, 0.0f, -0.5f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (4.0f, 0.0f,  0.5f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (2.0f, 0.0f,  1.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (1.0f, 0.0f,  1.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (1.0f, 0.0f,  6.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-2.0f, 0.0f, 6.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-2.0f, 0.0f, 1.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-7.0f, 0.0f, 0.5f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-7.0f, 0.0f, 2.0f) ).ScalarMult( scale ) );     m_vertices.push_back( ( Vec3 (-8.0f, 0.0f, 2.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-8.0f, 0.0f, -2.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-7.0f, 0.0f, -2.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-7.0f, 0.0f, -0.5f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-2.0f, 0.0f, -1.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (-2.0f, 0.0f, -6.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (1.0f, 0.0f,  -6.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (1.0f, 0.0f,  -1.0f) ).ScalarMult( scale ) );
-    m_vertices.push_back( ( Vec3 (2.0f, 0.0f,  -1.0f) ).ScalarMult( scale ) );
+    // C152 outline in local space (unit scale), built at compile time.
+    constexpr Vector3<float> c_outline[] =
+    {
+        // Fuselage
+        { 4.0f, 0.0f, -0.5f }, { 4.0f, 0.0f,  0.5f }, { 2.0f, 0.0f,  1.0f },
+        { 1.0f, 0.0f,  1.0f }, { 1.0f, 0.0f,  6.0f }, { -2.0f, 0.0f, 6.0f },
+        { -2.0f, 0.0f, 1.0f }, { -7.0f, 0.0f, 0.5f }, { -7.0f, 0.0f, 2.0f },
+        { -8.0f, 0.0f, 2.0f }, { -8.0f, 0.0f, -2.0f }, { -7.0f, 0.0f, -2.0f },
+        { -7.0f, 0.0f, -0.5f }, { -2.0f, 0.0f, -1.0f }, { -2.0f, 0.0f, -6.0f },
+        { 1.0f, 0.0f,  -6.0f }, { 1.0f, 0.0f,  -1.0f }, { 2.0f, 0.0f,  -1.0f }
+    };
+
+    const size_t c_numOutlineVertices = sizeof( c_outline ) / sizeof( c_outline[0] );
+
+    // Indexed by AeroplaneRenderModel::Colors.
+    constexpr Vector3<GLfloat> c_colors[] =
+    {
+        { 1.0f, 0.0f, 0.0f }, //< eRed
+        { 0.0f, 1.0f, 0.0f }, //< eGreen
+        { 0.0f, 0.0f, 1.0f }, //< eBlue
+        { 1.0f, 1.0f, 1.0f }  //< eWhite
+    };
+}
+
+GLsizei AeroplaneRenderModel::GenerateVertices( float scale, std::vector< GLfloat >& vertices )
+{
+    const Vector3<float> blades[] = { { 0.0f, 0.0f, 2.5f }, { 0.0f, 0.0f, -2.5f } };
+    const size_t numBladeVertices = sizeof( blades ) / sizeof( blades[0] );
+
+    vertices.resize( 0 );
+    vertices.reserve( 3 * ( c_numOutlineVertices + numBladeVertices ) );
+
+    for( size_t i = 0; i < c_numOutlineVertices; ++i )
+    {
+        const Vector3<float> v = c_outline[ i ].ScalarMult( scale );
+        vertices.push_back( v.GetX() );
+        vertices.push_back( v.GetY() );
+        vertices.push_back( v.GetZ() );
+    }
+
+    for( size_t i = 0; i < numBladeVertices; ++i )
+    {
+        const Vector3<float> v = blades[ i ].ScalarMult( scale );
+        vertices.push_back( v.GetX() );
+        vertices.push_back( v.GetY() );
+        vertices.push_back( v.GetZ() );
+    }
+
+    return static_cast<GLsizei>( c_numOutlineVertices );
 }
 
 void AeroplaneRenderModel::MakeColors()
 {
-    m_colors.resize( Colors::eMaxNumOfCols );
-    
-    m_colors[ Colors::eRed ]   = Vec3GL( 1.0f, 0.0f, 0.0f );
-    m_colors[ Colors::eGreen ] = Vec3GL( 0.0f, 1.0f, 0.0f );
-    m_colors[ Colors::eBlue ]  = Vec3GL( 0.0f, 0.0f, 1.0f );
-    m_colors[ Colors::eWhite ] = Vec3GL( 1.0f, 1.0f, 1.0f );
+    static_assert( sizeof( c_colors ) / sizeof( c_colors[0] ) == Colors::eMaxNumOfCols, "one color per Colors entry" );
+    m_colors.assign( c_colors, c_colors + Colors::eMaxNumOfCols );
 }
 
 AeroplaneRenderModel::AeroplaneRenderModel( float scale )
     : m_prop( scale )
+    , m_vbo( 0 )
 {
       MakeColors();
-      GenerateVertices( scale );
-      m_lines.resize( m_vertices.size() );
-      Update( Vec3(0.0f, 0.0f, 0.0f), Quat( 0.0f, 0.0f, 0.0f, 1.0f ) ); //< identity quaternion)
+      m_numOutlineVertices = GenerateVertices( scale, m_vertices );
+      SetPose( Matrix4<float>().CalculateTransformMatrix( Vector4<float>( 0.0f, 0.0f, 0.0f, 0.0f ),
+                                                          Quat( 0.0f, 0.0f, 0.0f, 1.0f ) ) ); //< identity
 }
 
-void AeroplaneRenderModel::Update( const Vec3& pos, const Quat& orient )
+AeroplaneRenderModel::~AeroplaneRenderModel()
 {
-    const Quat orientCnj = ~orient;
-    Vec3 from, to; //< Global space
-
-    const size_t size = m_vertices.size();
-
-    for( size_t i = 0; i < (size + 1); ++i )
+    if( m_vbo )
     {
-        // Rotate.
-        from = orientCnj.RotateFast( m_vertices[ i % size ] );
-        to   = orientCnj.RotateFast( m_vertices[ (i + 1) % size ] );
-
-        // Translate.
-        from += pos;
-        to   += pos;
-        
-        m_lines[ i % size ] = GLLine( from, to, m_colors[ Colors::eWhite ] );
+        glDeleteBuffers( 1, &m_vbo );
     }
+}
 
-    // Prop
-    m_prop.Spin();
-    // Rotation
-    from = orientCnj.RotateFast( m_prop.m_vertices[ 0 ] );
-    to   = orientCnj.RotateFast( m_prop.m_vertices[ 1 ] );
-    // translation
-     from += (pos + orientCnj.RotateFast( m_prop.m_pos ));
-     to   += (pos + orientCnj.RotateFast( m_prop.m_pos ));
-     m_prop.m_line = GLLine( from, to, m_colors[ Colors::eWhite ] );
+void AeroplaneRenderModel::SetPose( const Matrix4<float>& transform )
+{
+    transform.GetColumnMajor( m_modelMatrix );
 }
 
-void AeroplaneRenderModel::Draw() const
+void AeroplaneRenderModel::Draw()
 {
-    for( size_t i = 0; i < m_lines.size(); ++i )
+    // Static geometry, uploaded once (buffer objects are GL 1.5).
+    if( !m_vbo )
     {
-        m_lines[ i ].Draw();
+        glGenBuffers( 1, &m_vbo );
+        glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+        glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( m_vertices.size() * sizeof( GLfloat ) ), &m_vertices[0], GL_STATIC_DRAW );
+        glBindBuffer( GL_ARRAY_BUFFER, 0 );
     }
 
-    m_prop.Draw();
-}
-
-Aeroplane::Aeroplane()
-    : m_pos( 0.0f, 0.0f, 0.0f )
-    , m_orient( 0.0f, 0.0f, 0.0f, 1.0f ) //< identity quaternion
-    , m_renderModel( 0.3f )
-{
-}
+    const Vec3GL& white = m_colors[ Colors::eWhite ];
+    glColor3f( white.GetX(), white.GetY(), white.GetZ() );
 
-void Aeroplane::SyncRenderModel()
-{
-    m_renderModel.Update( m_pos, m_orient );  
-}
+    glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, 0, NULL );
 
+    glPushMatrix();
+    glMultMatrixf( m_modelMatrix );
+    glDrawArrays( GL_LINE_LOOP, 0, m_numOutlineVertices );
 
-void Aeroplane::SetHDG( float HDG_DEG )
-{
-    const Vector3<float> upDir( 0.0f, 1.0f, 0.0f );
-    m_orient.FromAxisAngle( upDir, Deg2Rad( HDG_DEG ) );
-}
+    // Blades in the hub's frame, on top of the aeroplane's.
+    glMultMatrixf( m_prop.m_modelMatrix );
+    glDrawArrays( GL_LINES, m_numOutlineVertices, 2 );
+    glPopMatrix();
 
-void Aeroplane::AddRotation( const Quaternion<float>& rotation )
-{
-    m_orient = m_orient * rotation;
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
 }
 
-const Matrix3<float> Aeroplane::GetOrientationMatrix( void ) const
+Aeroplane::Aeroplane()
+    : m_renderModel( 0.3f )
+    , m_renderRevision( GetPoseRevision() - 1 ) //< First Draw() syncs.
 {
-    Matrix3<float> orient;
-    orient.FromQuat( m_orient );
-    return orient;
 }
 
-const Matrix4<float> Aeroplane::GetTransformMatrix( void ) const
+// The model matrix is copied only when the pose changed since the last frame,
+// the propeller turns every frame.
+void Aeroplane::SyncRenderModel()
 {
-    Matrix4<float> tm;
-    tm.CalculateTransformMatrix( Vector4<float>( m_pos.GetX(),
-                                                 m_pos.GetY(),
-                                                 m_pos.GetZ(), 0.0f), m_orient );
-      return tm;
+    if( m_renderRevision != GetPoseRevision() )
+    {
+        m_renderModel.SetPose( GetTransformMatrix() );
+        m_renderRevision = GetPoseRevision();
+    }
+    m_renderModel.SpinPropeller();
 }
 
 void Aeroplane::Draw()
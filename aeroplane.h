@@ -9,10 +9,13 @@
 #include "matrix4.h"
 #include "vector3.h"
 #include "quat.h"
-#include "glLine.h"
+#include "aeroplaneKinematics.h"
 
 using namespace GrapheneMath;
 
+// C152 outline drawn on the GPU: the local space geometry is uploaded once to a
+// vertex buffer and placed with the aeroplane's model matrix, so a pose change
+// costs 16 floats instead of transforming every vertex on the CPU.
 class AeroplaneRenderModel
 {
 private:
@@ -34,28 +37,20 @@ private:
     
     struct Propeller
     {
-      std::vector< Vec3 >     m_verticesL; //< Read only.
-      std::vector< Vec3 >     m_vertices;  //< Transformed.
-      GLLine                  m_line; 
       Vec3                    m_pos;      //< in local aeroplane space
       Quat                    m_propOrient;
       const Vec3              c_propRotAxis;
       Quat                    m_propRevs;
+      GLfloat                 m_modelMatrix[ 16 ]; //< column-major, in aeroplane space
       
       Propeller( float scale )
        : m_pos( 4.0f, 0.0f, 0.0f )
        , m_propOrient( 0.0f, 0.0f, 0.0f, 1.0f ) 
        , c_propRotAxis( 1.0f, 0.0f, 0.0f )
       {
-        m_verticesL.resize( 0 );      
-        // Propeller blades
         m_pos = m_pos.ScalarMult( scale );
-        m_verticesL.push_back( (Vec3 ( 0.0f, 0.0f,  2.5f )).ScalarMult( scale ) );
-        m_verticesL.push_back( (Vec3 ( 0.0f, 0.0f, -2.5f )).ScalarMult( scale ) );
-        
-        m_vertices.resize( m_verticesL.size() );
-          
         m_propRevs.FromAxisAngle( c_propRotAxis, Deg2Rad( 20.0f ) );
+        Spin();
       }
       
       void Spin()
@@ -64,58 +59,58 @@ private:
         m_propOrient = m_propOrient * m_propRevs;
         m_propOrient.Normalise();
         
-        // Transform vertices.
-        for( size_t i = 0; i < m_verticesL.size(); ++i ) {
-            m_vertices[i] = m_propOrient.RotateFast( m_verticesL[i] );
-        }  
+        // The blades turn with m_propOrient about the hub.
+        Matrix4<float> transform;
+        transform.CalculateTransformMatrix( Vector4<float>( m_pos.GetX(), m_pos.GetY(), m_pos.GetZ(), 0.0f ), ~m_propOrient );
+        transform.GetColumnMajor( m_modelMatrix );
       }
-      
-      void Draw() const { m_line.Draw(); }
     } m_prop;
     
-    std::vector< Vec3 >     m_vertices; //< vertices in local space.  
-    std::vector< GLLine >   m_lines;    //< GLLines buffer in Global space.
+    std::vector< GLfloat >  m_vertices;     //< outline then blade tips, x y z, local space
+    GLsizei                 m_numOutlineVertices;
     std::vector< Vec3GL >   m_colors;
+    GLuint                  m_vbo;          //< m_vertices, uploaded on the first Draw()
+    GLfloat                 m_modelMatrix[ 16 ]; //< column-major, pose of the last SetPose()
 
-    // Fills in the m_vertices buffer.
-    void GenerateVertices( float scale );
     void MakeColors();
 
+    // Non-copyable, owns the vertex buffer.
+    AeroplaneRenderModel( const AeroplaneRenderModel& );
+    AeroplaneRenderModel& operator=( const AeroplaneRenderModel& );
+
 public:
     AeroplaneRenderModel( float scale );
+    ~AeroplaneRenderModel();
+
+    // Local space geometry, x y z per vertex: the outline as a closed line
+    // loop, then the two blade tips around the hub. Returns the number of
+    // outline vertices.
+    static GLsizei GenerateVertices( float scale, std::vector< GLfloat >& vertices );
+
+    // Places the model with a rigid transform, AeroplaneKinematics::GetTransformMatrix.
+    void SetPose( const Matrix4<float>& transform );
 
-    void Update( const Vec3& pos, const Quat& orient );
-    void Draw() const;
+    // Turns the propeller one step, every frame.
+    void SpinPropeller() { m_prop.Spin(); }
+
+    // Draws the closed outline and the propeller. Needs the GL context current,
+    // the first call uploads the geometry.
+    void Draw();
 };
 
 
-class Aeroplane
+// Aircraft kinematics with its debug render model.
+class Aeroplane : public AeroplaneKinematics
 {
 private:
-  Vector3<float>       m_pos;
-  Vector3<float>       m_vel;
-  Quaternion<float>    m_orient;
-  Matrix4<float>       m_tm;
   AeroplaneRenderModel m_renderModel;
+  unsigned             m_renderRevision; //< Pose revision the render model shows.
 
   void SyncRenderModel();
 
 public:
   Aeroplane();
 
-  void SetHDG( float HDG_DEG );
-  void SetOrientation( const Quaternion<float>& orient ) { m_orient = orient; }
-  void SetPosition( const Vector3<float>& pos ) { m_pos = pos; }
-  void SetVelocity( const Vector3<float>& vel ) { m_vel = vel; }
-
-  const Vector3<float> GetPosition() const { return m_pos; }
-  const Vector3<float> GetVelocity() const { return m_vel; }
-  const Quaternion<float> GetOrientation() const { return m_orient; }
-  const Matrix3<float> GetOrientationMatrix() const;
-  const Matrix4<float> GetTransformMatrix() const;
-
-  void AddRotation( const Quaternion<float>& rotation );
-
   void Draw();
 };
 
@@ -0,0 +1,249 @@
+// Shaders, buffer objects and instancing are called directly, libGL exports
+// them on the platforms this builds on.
+#define GL_GLEXT_PROTOTYPES
+
+#include <cstddef>
+#include <cstdio>
+#include "aeroplaneFleet.h"
+#include "aeroplane.h"
+#include "matrix4.h"
+
+namespace
+{
+    // v' = R( ~q ) v + pos, the rotation of Matrix4::CalculateTransformMatrix.
+    const char* const c_vertexShader =
+        "#version 120\n"
+        "attribute vec3 a_vertex;\n"
+        "attribute vec3 a_position;\n"
+        "attribute vec4 a_orient;\n"
+        "attribute vec3 a_color;\n"
+        "varying vec3 v_color;\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 u = -a_orient.xyz;\n"
+        "    float w = a_orient.w;\n"
+        "    vec3 p = ( 2.0 * w * w - 1.0 ) * a_vertex + 2.0 * w * cross( u, a_vertex ) + 2.0 * dot( u, a_vertex ) * u;\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * vec4( p + a_position, 1.0 );\n"
+        "    v_color = a_color;\n"
+        "}\n";
+
+    const char* const c_fragmentShader =
+        "#version 120\n"
+        "varying vec3 v_color;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = vec4( v_color, 1.0 );\n"
+        "}\n";
+
+    GLuint CompileShader( GLenum type, const char* source )
+    {
+        const GLuint shader = glCreateShader( type );
+        glShaderSource( shader, 1, &source, NULL );
+        glCompileShader( shader );
+
+        GLint compiled = GL_FALSE;
+        glGetShaderiv( shader, GL_COMPILE_STATUS, &compiled );
+        if( !compiled )
+        {
+            char log[512];
+            glGetShaderInfoLog( shader, sizeof( log ), NULL, log );
+            fprintf( stderr, "AeroplaneFleet: shader compilation failed: %s\n", log );
+            glDeleteShader( shader );
+            return 0;
+        }
+        return shader;
+    }
+}
+
+AeroplaneFleet::AeroplaneFleet( float scale, size_t expectedAircraft, bool allowInstancing )
+    : m_path( eUninitialised )
+    , m_allowInstancing( allowInstancing )
+    , m_modelVbo( 0 )
+    , m_instanceVbo( 0 )
+    , m_instanceCapacity( expectedAircraft > 0 ? expectedAircraft : 1 )
+    , m_program( 0 )
+{
+    m_instances.reserve( m_instanceCapacity );
+
+    // The outline loop and the blades as GL_LINES, one draw for the model.
+    std::vector<GLfloat> model;
+    const GLsizei numOutline = AeroplaneRenderModel::GenerateVertices( scale, model );
+    const GLsizei numVertices = static_cast<GLsizei>( model.size() / 3 );
+
+    m_vertices.reserve( 6 * numOutline + 3 * ( numVertices - numOutline ) );
+    for( GLsizei i = 0; i < numOutline; ++i )
+    {
+        const GLfloat* a = &model[ 3 * i ];
+        const GLfloat* b = &model[ 3 * ( ( i + 1 ) % numOutline ) ];
+        m_vertices.insert( m_vertices.end(), a, a + 3 );
+        m_vertices.insert( m_vertices.end(), b, b + 3 );
+    }
+    m_vertices.insert( m_vertices.end(), model.begin() + 3 * numOutline, model.end() );
+}
+
+AeroplaneFleet::~AeroplaneFleet()
+{
+    if( m_program )
+    {
+        glDeleteProgram( m_program );
+    }
+    if( m_instanceVbo )
+    {
+        glDeleteBuffers( 1, &m_instanceVbo );
+    }
+    if( m_modelVbo )
+    {
+        glDeleteBuffers( 1, &m_modelVbo );
+    }
+}
+
+// Instanced arrays need GL 3.3, the model buffer GL 1.5.
+void AeroplaneFleet::SelectPath()
+{
+    glGenBuffers( 1, &m_modelVbo );
+    glBindBuffer( GL_ARRAY_BUFFER, m_modelVbo );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( m_vertices.size() * sizeof( GLfloat ) ), &m_vertices[0], GL_STATIC_DRAW );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    int major = 0;
+    int minor = 0;
+    const char* version = reinterpret_cast<const char*>( glGetString( GL_VERSION ) );
+    if( version )
+    {
+        sscanf( version, "%d.%d", &major, &minor );
+    }
+
+    const bool instancing = m_allowInstancing && ( ( major > 3 ) || ( major == 3 && minor >= 3 ) );
+    m_path = ( instancing && CreateProgram() ) ? eInstanced : ePerAircraft;
+}
+
+bool AeroplaneFleet::CreateProgram()
+{
+    const GLuint vertexShader = CompileShader( GL_VERTEX_SHADER, c_vertexShader );
+    const GLuint fragmentShader = CompileShader( GL_FRAGMENT_SHADER, c_fragmentShader );
+    if( !vertexShader || !fragmentShader )
+    {
+        glDeleteShader( vertexShader );
+        glDeleteShader( fragmentShader );
+        return false;
+    }
+
+    m_program = glCreateProgram();
+    glAttachShader( m_program, vertexShader );
+    glAttachShader( m_program, fragmentShader );
+    glBindAttribLocation( m_program, eAttribVertex, "a_vertex" );
+    glBindAttribLocation( m_program, eAttribPosition, "a_position" );
+    glBindAttribLocation( m_program, eAttribOrient, "a_orient" );
+    glBindAttribLocation( m_program, eAttribColor, "a_color" );
+    glLinkProgram( m_program );
+
+    // Owned by the program from here on.
+    glDeleteShader( vertexShader );
+    glDeleteShader( fragmentShader );
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv( m_program, GL_LINK_STATUS, &linked );
+    if( !linked )
+    {
+        char log[512];
+        glGetProgramInfoLog( m_program, sizeof( log ), NULL, log );
+        fprintf( stderr, "AeroplaneFleet: program link failed: %s\n", log );
+        glDeleteProgram( m_program );
+        m_program = 0;
+        return false;
+    }
+
+    glGenBuffers( 1, &m_instanceVbo );
+    return true;
+}
+
+void AeroplaneFleet::DrawInstanced()
+{
+    const size_t numInstances = m_instances.size();
+    if( numInstances > m_instanceCapacity )
+    {
+        m_instanceCapacity = m_instances.capacity();
+    }
+
+    // Orphan last frame's storage, the driver hands out a fresh block while
+    // the GPU may still be reading the old one.
+    glBindBuffer( GL_ARRAY_BUFFER, m_instanceVbo );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( m_instanceCapacity * sizeof( Instance ) ), NULL, GL_STREAM_DRAW );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>( numInstances * sizeof( Instance ) ), &m_instances[0] );
+
+    glVertexAttribPointer( eAttribPosition, 3, GL_FLOAT, GL_FALSE, sizeof( Instance ), reinterpret_cast<const GLvoid*>( offsetof( Instance, pos ) ) );
+    glVertexAttribPointer( eAttribOrient, 4, GL_FLOAT, GL_FALSE, sizeof( Instance ), reinterpret_cast<const GLvoid*>( offsetof( Instance, orient ) ) );
+    glVertexAttribPointer( eAttribColor, 3, GL_FLOAT, GL_FALSE, sizeof( Instance ), reinterpret_cast<const GLvoid*>( offsetof( Instance, color ) ) );
+    for( GLuint attrib = eAttribPosition; attrib <= eAttribColor; ++attrib )
+    {
+        glVertexAttribDivisor( attrib, 1 );
+        glEnableVertexAttribArray( attrib );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, m_modelVbo );
+    glVertexAttribPointer( eAttribVertex, 3, GL_FLOAT, GL_FALSE, 0, NULL );
+    glEnableVertexAttribArray( eAttribVertex );
+
+    glUseProgram( m_program );
+    glDrawArraysInstanced( GL_LINES, 0, static_cast<GLsizei>( m_vertices.size() / 3 ), static_cast<GLsizei>( numInstances ) );
+    glUseProgram( 0 );
+
+    // Leave the attributes as the fixed-function code expects them.
+    for( GLuint attrib = eAttribVertex; attrib <= eAttribColor; ++attrib )
+    {
+        glDisableVertexAttribArray( attrib );
+        glVertexAttribDivisor( attrib, 0 );
+    }
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+// One model matrix and one draw call per aircraft.
+void AeroplaneFleet::DrawPerAircraft() const
+{
+    glBindBuffer( GL_ARRAY_BUFFER, m_modelVbo );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, 0, NULL );
+
+    const GLsizei numVertices = static_cast<GLsizei>( m_vertices.size() / 3 );
+    Matrix4<float> transform;
+    GLfloat modelMatrix[ 16 ];
+    for( size_t i = 0; i < m_instances.size(); ++i )
+    {
+        const Instance& instance = m_instances[i];
+        transform.CalculateTransformMatrix( Vector4<float>( instance.pos[0], instance.pos[1], instance.pos[2], 0.0f ),
+                                            Quaternion<float>( instance.orient[0], instance.orient[1], instance.orient[2], instance.orient[3] ) );
+        transform.GetColumnMajor( modelMatrix );
+
+        glColor3fv( instance.color );
+        glPushMatrix();
+        glMultMatrixf( modelMatrix );
+        glDrawArrays( GL_LINES, 0, numVertices );
+        glPopMatrix();
+    }
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+void AeroplaneFleet::Flush()
+{
+    if( m_path == eUninitialised )
+    {
+        SelectPath();
+    }
+
+    if( !m_instances.empty() )
+    {
+        if( m_path == eInstanced )
+        {
+            DrawInstanced();
+        }
+        else
+        {
+            DrawPerAircraft();
+        }
+    }
+
+    // Keeps the capacity for the next frame.
+    m_instances.clear();
+}
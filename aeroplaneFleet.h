@@ -0,0 +1,108 @@
+#ifndef __AEROPLANE_FLEET_H__
+#define __AEROPLANE_FLEET_H__
+
+#include <assert.h>
+#include <cstddef>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+#include <GL/glext.h>
+
+#include "vector3.h"
+#include "quat.h"
+#include "aeroplaneKinematics.h"
+
+using namespace GrapheneMath;
+
+// Draws many aircraft of the same model (traffic, scenario playback) with one
+// instanced draw call per frame.
+//
+// The model geometry (AeroplaneRenderModel::GenerateVertices, expanded to
+// GL_LINES) lives in a static vertex buffer. Every frame the aircraft are
+// submitted with Add(), position, orientation quaternion and colour per
+// instance, and Flush() streams them into an orphaned instance buffer and
+// draws them all with glDrawArraysInstanced; a small vertex shader rotates and
+// places each model the way AeroplaneKinematics::GetTransformMatrix does.
+// Needs GL 3.3 (instanced arrays), below that every aircraft is drawn with its
+// own model matrix, one draw call each (also when instancing is not allowed,
+// to compare both paths on the same context). The propellers do not spin.
+class AeroplaneFleet
+{
+public:
+    // Streamed per aircraft, tightly packed.
+    struct Instance
+    {
+        GLfloat pos[3];
+        GLfloat orient[4]; //< x y z w
+        GLfloat color[3];
+    };
+
+private:
+    enum Path
+    {
+        eUninitialised = 0,
+        eInstanced,
+        ePerAircraft
+    };
+
+    // Generic vertex attribute locations of the instancing program.
+    enum Attributes
+    {
+        eAttribVertex = 0,
+        eAttribPosition,
+        eAttribOrient,
+        eAttribColor
+    };
+
+    std::vector<Instance> m_instances;        //< submitted this frame
+    std::vector<GLfloat>  m_vertices;         //< model, GL_LINES, x y z, local space
+    Path                  m_path;
+    bool                  m_allowInstancing;
+    GLuint                m_modelVbo;
+    GLuint                m_instanceVbo;
+    size_t                m_instanceCapacity; //< instances the instance buffer holds
+    GLuint                m_program;
+
+    void SelectPath();
+    bool CreateProgram();
+    void DrawInstanced();
+    void DrawPerAircraft() const;
+
+    // Non-copyable, owns GL objects.
+    AeroplaneFleet( const AeroplaneFleet& );
+    AeroplaneFleet& operator=( const AeroplaneFleet& );
+
+public:
+    // 'expectedAircraft' sizes the instance arrays, they grow on demand.
+    // Without 'allowInstancing' Flush() always takes the per aircraft path.
+    explicit AeroplaneFleet( float scale, size_t expectedAircraft = 1024, bool allowInstancing = true );
+    ~AeroplaneFleet();
+
+    inline void Add( const Vector3<float>& pos,
+                     const Quaternion<float>& orient,
+                     const Vector3<GLfloat>& color )
+    {
+        const Instance instance =
+        {
+            { pos.GetX(), pos.GetY(), pos.GetZ() },
+            { orient.GetX(), orient.GetY(), orient.GetZ(), orient.GetW() },
+            { color.GetX(), color.GetY(), color.GetZ() }
+        };
+        m_instances.push_back( instance );
+    }
+
+    inline void Add( const AeroplaneKinematics& aeroplane, const Vector3<GLfloat>& color )
+    {
+        Add( aeroplane.GetPosition(), aeroplane.GetOrientation(), color );
+    }
+
+    size_t GetNumAircraft() const { return m_instances.size(); }
+
+    bool IsInstanced() const { return m_path == eInstanced; }
+
+    // Draws the aircraft submitted since the last Flush() and starts a new frame.
+    // Needs the GL context current, the first call picks the path.
+    void Flush();
+};
+
+#endif //__AEROPLANE_FLEET_H__
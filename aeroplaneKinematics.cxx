@@ -0,0 +1,47 @@
+#include "aeroplaneKinematics.h"
+
+using namespace GrapheneMath;
+
+AeroplaneKinematics::AeroplaneKinematics()
+    : m_orientMatrixDirty( true )
+    , m_transformMatrixDirty( true )
+    , m_poseRevision( 0 )
+    , m_pos( 0.0f, 0.0f, 0.0f )
+    , m_orient( 0.0f, 0.0f, 0.0f, 1.0f ) //< identity quaternion
+{
+}
+
+void AeroplaneKinematics::SetHDG( float HDG_DEG )
+{
+    const Vector3<float> upDir( 0.0f, 1.0f, 0.0f );
+    m_orient.FromAxisAngle( upDir, Deg2Rad( HDG_DEG ) );
+    OrientationChanged();
+}
+
+void AeroplaneKinematics::AddRotation( const Quaternion<float>& rotation )
+{
+    m_orient = m_orient * rotation;
+    OrientationChanged();
+}
+
+const Matrix3<float>& AeroplaneKinematics::GetOrientationMatrix( void ) const
+{
+    if( m_orientMatrixDirty )
+    {
+        m_orientMatrix.FromQuat( m_orient );
+        m_orientMatrixDirty = false;
+    }
+    return m_orientMatrix;
+}
+
+const Matrix4<float>& AeroplaneKinematics::GetTransformMatrix( void ) const
+{
+    if( m_transformMatrixDirty )
+    {
+        m_transformMatrix.CalculateTransformMatrix( Vector4<float>( m_pos.GetX(),
+                                                                    m_pos.GetY(),
+                                                                    m_pos.GetZ(), 0.0f), m_orient );
+        m_transformMatrixDirty = false;
+    }
+    return m_transformMatrix;
+}
@@ -0,0 +1,54 @@
+#ifndef __AEROPLANE_KINEMATICS_H__
+#define __AEROPLANE_KINEMATICS_H__
+
+#include "matrix4.h"
+#include "vector3.h"
+#include "quat.h"
+
+using namespace GrapheneMath;
+
+// Aircraft pose and velocity, free of any rendering code so that it can be
+// used by headless tools (batch planners, benchmarks) through libnavex_core.
+//
+// The matrices derived from the pose are cached and rebuilt on first use after
+// SetHDG, SetOrientation, SetPosition or AddRotation, so a pose that does not
+// change costs nothing per frame.
+class AeroplaneKinematics
+{
+private:
+  mutable Matrix3<float> m_orientMatrix;
+  mutable Matrix4<float> m_transformMatrix;
+  mutable bool           m_orientMatrixDirty;
+  mutable bool           m_transformMatrixDirty;
+  unsigned               m_poseRevision; //< Incremented on every pose change.
+
+  void OrientationChanged() { m_orientMatrixDirty = true; m_transformMatrixDirty = true; ++m_poseRevision; }
+  void PositionChanged()    { m_transformMatrixDirty = true; ++m_poseRevision; }
+
+protected:
+  Vector3<float>       m_pos;
+  Vector3<float>       m_vel;
+  Quaternion<float>    m_orient;
+
+public:
+  AeroplaneKinematics();
+
+  void SetHDG( float HDG_DEG );
+  void SetOrientation( const Quaternion<float>& orient ) { m_orient = orient; OrientationChanged(); }
+  void SetPosition( const Vector3<float>& pos ) { m_pos = pos; PositionChanged(); }
+  void SetVelocity( const Vector3<float>& vel ) { m_vel = vel; }
+
+  const Vector3<float> GetPosition() const { return m_pos; }
+  const Vector3<float> GetVelocity() const { return m_vel; }
+  const Quaternion<float> GetOrientation() const { return m_orient; }
+  const Matrix3<float>& GetOrientationMatrix() const;
+  const Matrix4<float>& GetTransformMatrix() const;
+
+  // Changes whenever the pose does, lets observers (the render model) skip
+  // their own update when it is the same as last time.
+  unsigned GetPoseRevision() const { return m_poseRevision; }
+
+  void AddRotation( const Quaternion<float>& rotation );
+};
+
+#endif //__AEROPLANE_KINEMATICS_H__
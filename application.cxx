@@ -29,8 +29,9 @@ void Application::Update()
 
 void Application::Draw()
 {
-    //m_appModules[0]->Draw();
-    m_appModules[1]->Draw();
+    //m_appModules[0]->Draw( m_lineBatch );
+    m_appModules[1]->Draw( m_lineBatch );
+    m_lineBatch.Flush();
 }
 
 
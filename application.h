@@ -6,11 +6,13 @@
 
 #include "simulation.h"
 #include "deadReckoning.h"
+#include "lineBatch.h"
 
 class Application
 {
 private:
     std::vector<ApplicationModule*>  m_appModules;
+    LineBatch                        m_lineBatch; //< lines of all modules, one draw per frame
 
 public:
     Application();
@@ -1,12 +1,15 @@
 #ifndef __APPLICATION_MODULE_H__
 #define __APPLICATION_MODULE_H__
 
+class LineBatch;
+
 class ApplicationModule
 {
 public:
     virtual void Initialise() = 0;
     virtual void Update() = 0;
-    virtual void Draw() = 0;
+    // Submits the module's lines, the application draws them all at once.
+    virtual void Draw( LineBatch& batch ) = 0;
 
     virtual ~ApplicationModule(){};
 };
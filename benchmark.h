@@ -0,0 +1,133 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Minimal helpers for the micro benchmarks (see 'make bench' and 'make mathbench').
+namespace Benchmark
+{
+    // Wall clock timer with nanosecond resolution.
+    class Timer
+    {
+    private:
+        std::chrono::steady_clock::time_point m_start;
+
+    public:
+        Timer() { Start(); }
+
+        void Start() { m_start = std::chrono::steady_clock::now(); }
+
+        double ElapsedNs() const
+        {
+            return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - m_start ).count();
+        }
+    };
+
+    // Forces the compiler to materialise 'value', so that work producing it
+    // can't be optimised away.
+    template <typename T>
+    inline void DoNotOptimize( const T& value )
+    {
+        asm volatile( "" : : "r,m"( value ) : "memory" );
+    }
+
+    // Tells the compiler that all memory may have been read and written.
+    inline void ClobberMemory()
+    {
+        asm volatile( "" : : : "memory" );
+    }
+
+    // Timing of one case, ns per operation over the timed repetitions.
+    struct Result
+    {
+        std::string name;
+        double      medianNs;
+        double      p99Ns;
+        double      minNs;
+        unsigned    reps;
+        size_t      opsPerRep;
+    };
+
+    // Runs each case 'warmUpReps' times untimed (caches, branch predictors,
+    // CPU clock), then 'reps' times timed and keeps the median and the 99th
+    // percentile, which unlike the mean are robust to the odd preempted rep.
+    // A case is a functor doing 'opsPerRep' operations per call, long enough
+    // for the timer resolution (a loop over a small array).
+    class Runner
+    {
+    private:
+        unsigned            m_warmUpReps;
+        unsigned            m_reps;
+        std::vector<Result> m_results;
+
+    public:
+        explicit Runner( unsigned warmUpReps = 10, unsigned reps = 200 )
+            : m_warmUpReps( warmUpReps )
+            , m_reps( reps > 0 ? reps : 1 )
+        {}
+
+        template <typename F>
+        const Result& Run( const char* name, size_t opsPerRep, F fn )
+        {
+            for( unsigned r = 0; r < m_warmUpReps; ++r )
+            {
+                fn();
+                ClobberMemory();
+            }
+
+            std::vector<double> nsPerOp( m_reps );
+            for( unsigned r = 0; r < m_reps; ++r )
+            {
+                Timer timer;
+                fn();
+                ClobberMemory();
+                nsPerOp[r] = timer.ElapsedNs() / static_cast<double>( opsPerRep );
+            }
+            std::sort( nsPerOp.begin(), nsPerOp.end() );
+
+            Result result;
+            result.name      = name;
+            result.medianNs  = nsPerOp[ m_reps / 2 ];
+            result.p99Ns     = nsPerOp[ ( m_reps * 99 + 99 ) / 100 - 1 ];
+            result.minNs     = nsPerOp[0];
+            result.reps      = m_reps;
+            result.opsPerRep = opsPerRep;
+            m_results.push_back( result );
+            return m_results.back();
+        }
+
+        const std::vector<Result>& GetResults() const { return m_results; }
+
+        void PrintTable( FILE* out ) const
+        {
+            fprintf( out, "%-40s %10s %10s %10s\n", "case (ns per op)", "median", "p99", "min" );
+            for( size_t i = 0; i < m_results.size(); ++i )
+            {
+                const Result& r = m_results[i];
+                fprintf( out, "%-40s %10.2f %10.2f %10.2f\n", r.name.c_str(), r.medianNs, r.p99Ns, r.minNs );
+            }
+        }
+
+        // One JSON object per run, e.g. for tracking regressions between releases:
+        // { "suite": ..., "results": [ { "name": ..., "median_ns": ..., ... } ] }
+        void PrintJson( FILE* out, const char* suite ) const
+        {
+            fprintf( out, "{\n  \"suite\": \"%s\",\n  \"results\": [\n", suite );
+            for( size_t i = 0; i < m_results.size(); ++i )
+            {
+                const Result& r = m_results[i];
+                fprintf( out, "    { \"name\": \"%s\", \"median_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f, "
+                              "\"reps\": %u, \"ops_per_rep\": %lu }%s\n",
+                         r.name.c_str(), r.medianNs, r.p99Ns, r.minNs, r.reps,
+                         static_cast<unsigned long>( r.opsPerRep ), ( i + 1 < m_results.size() ) ? "," : "" );
+            }
+            fprintf( out, "  ]\n}\n" );
+        }
+    };
+}
+
+#endif //__BENCHMARK_H__
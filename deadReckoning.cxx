@@ -4,11 +4,13 @@
 
 using namespace GrapheneMath;
 
-const Vector3<GLfloat> HelperLines::Colors::c_redColor( 1.0f, 0.0f, 0.0f );
-const Vector3<GLfloat> HelperLines::Colors::c_greenColor( 0.0f, 1.0f, 0.0f );
-const Vector3<GLfloat> HelperLines::Colors::c_blueColor( 0.0f, 0.0f, 1.0f );
-const Vector3<GLfloat> HelperLines::Colors::c_chartreuseColor( 0.5f, 1.0f, 0.0f );
-const Vector3<GLfloat> HelperLines::Colors::c_lightChartreuseColor( 0.498f, 0.7f, 0.0f );
+// Compile-time constants, initialised in the class. These definitions are
+// only needed because the constants are bound to references.
+constexpr Vector3<GLfloat> HelperLines::Colors::c_redColor;
+constexpr Vector3<GLfloat> HelperLines::Colors::c_greenColor;
+constexpr Vector3<GLfloat> HelperLines::Colors::c_blueColor;
+constexpr Vector3<GLfloat> HelperLines::Colors::c_chartreuseColor;
+constexpr Vector3<GLfloat> HelperLines::Colors::c_lightChartreuseColor;
 
 const Vector3<GLfloat>& HelperLines::Colors::getColorFromIndex( const ColorIndex& idx )
 {
@@ -22,10 +24,10 @@ const Vector3<GLfloat>& HelperLines::Colors::getColorFromIndex( const ColorIndex
     }
 }
 
-const Vector3<GLfloat> HelperLines::c_zeroVec( 0.0f, 0.0f, 0.0f );
-const Vector3<GLfloat> HelperLines::c_xAxis  ( 1.0f, 0.0f, 0.0f );
-const Vector3<GLfloat> HelperLines::c_yAxis  ( 0.0f, 1.0f, 0.0f );
-const Vector3<GLfloat> HelperLines::c_zAxis  ( 0.0f, 0.0f, 1.0f );
+constexpr Vector3<GLfloat> HelperLines::c_zeroVec;
+constexpr Vector3<GLfloat> HelperLines::c_xAxis;
+constexpr Vector3<GLfloat> HelperLines::c_yAxis;
+constexpr Vector3<GLfloat> HelperLines::c_zAxis;
 
 
 
@@ -150,11 +152,11 @@ void DeadReckoning::Update()
     }
 }
 
-void DeadReckoning::Draw()
+void DeadReckoning::Draw( LineBatch& batch )
 {
-    m_wv.Draw();
+    m_wv.Draw( batch );
     m_C152.Draw();
-    m_helperLines.draw();
+    m_helperLines.draw( batch );
 }
 
 void DeadReckoning::makeReferenceFrame()
@@ -208,13 +210,13 @@ void DeadReckoning::makeLateralLines()
     {
         if( windToDotLongitudinal > 0.0f ) // IV quadrant
         {
-            angleLateralAxis45 += GrapheneMath::PI;
-            angleLateralAxis60 += GrapheneMath::PI;
+            angleLateralAxis45 += GrapheneMath::Constants<float>::Pi();
+            angleLateralAxis60 += GrapheneMath::Constants<float>::Pi();
         }
         else                               // III quadrant
         {
-            angleLateralAxis45 = GrapheneMath::PI - angleLateralAxis45;
-            angleLateralAxis60 = GrapheneMath::PI - angleLateralAxis60;
+            angleLateralAxis45 = GrapheneMath::Constants<float>::Pi() - angleLateralAxis45;
+            angleLateralAxis60 = GrapheneMath::Constants<float>::Pi() - angleLateralAxis60;
         }
     }
     else  // I or II quadrant
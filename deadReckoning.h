@@ -13,6 +13,7 @@
 #include "quat.h"
 #include "matrix4.h"
 #include "glLine.h"
+#include "lineBatch.h"
 #include "xlocator.h"
 #include "varrow2d.h"
 #include "wv.h"
@@ -88,28 +89,22 @@ public:
 
         typedef ColorIdx::Idx ColorIndex;
 
-        static const Vector3<GLfloat> c_redColor;
-        static const Vector3<GLfloat> c_greenColor;
-        static const Vector3<GLfloat> c_blueColor;
-        static const Vector3<GLfloat> c_chartreuseColor;
-        static const Vector3<GLfloat> c_lightChartreuseColor;
+        static constexpr Vector3<GLfloat> c_redColor             { 1.0f, 0.0f, 0.0f };
+        static constexpr Vector3<GLfloat> c_greenColor           { 0.0f, 1.0f, 0.0f };
+        static constexpr Vector3<GLfloat> c_blueColor            { 0.0f, 0.0f, 1.0f };
+        static constexpr Vector3<GLfloat> c_chartreuseColor      { 0.5f, 1.0f, 0.0f };
+        static constexpr Vector3<GLfloat> c_lightChartreuseColor { 0.498f, 0.7f, 0.0f };
 
         static const Vector3<GLfloat>& getColorFromIndex( const ColorIndex& );
     };
 
-    static const Vector3<GLfloat> c_zeroVec;
-    static const Vector3<GLfloat> c_xAxis;
-    static const Vector3<GLfloat> c_yAxis;
-    static const Vector3<GLfloat> c_zAxis;
+    static constexpr Vector3<GLfloat> c_zeroVec { 0.0f, 0.0f, 0.0f };
+    static constexpr Vector3<GLfloat> c_xAxis   { 1.0f, 0.0f, 0.0f };
+    static constexpr Vector3<GLfloat> c_yAxis   { 0.0f, 1.0f, 0.0f };
+    static constexpr Vector3<GLfloat> c_zAxis   { 0.0f, 0.0f, 1.0f };
 
 private:
-    struct GLStyleLine
-    {
-        GLLine                m_line;
-        LineDrawStyle::Style  m_style;
-    };
-
-    std::vector<GLStyleLine>  m_lines;
+    std::vector<GLLine>  m_lines; //< style set as the line's stipple pattern
 
 public:
     HelperLines()
@@ -123,32 +118,22 @@ public:
               Colors::ColorIndex      colorIdx,
               LineDrawStyle::Style    style )
     {
-        m_lines[ lineIdx ].m_line.Set( from, to, Colors::getColorFromIndex( colorIdx ) );
-        m_lines[ lineIdx ].m_style = style;
+        m_lines[ lineIdx ].Set( from, to, Colors::getColorFromIndex( colorIdx ) );
+        m_lines[ lineIdx ].SetPattern( LineBatch::GetPattern( ( style == LineDrawStyle::Style::eStipple ) ? LineBatch::eStipple
+                                                                                                         : LineBatch::eSolid ) );
     }
 
-    void draw()
+    // Every line goes to the batch, hidden ones with the hidden pattern, which
+    // the batch drops without a state change.
+    void draw( LineBatch& batch )
     {
-        int16_t bit;
+        GLLine* const lines = batch.AddLines( m_lines.size(), LineBatch::eStipple );
         for( uint8_t i = 0; i < m_lines.size(); i++ )
         {
-            bit = 1 << i;
-            if( m_lineVisibility.m_mask & bit )
+            lines[i] = m_lines[i];
+            if( !( m_lineVisibility.m_mask & ( 1 << i ) ) )
             {
-                switch( m_lines[i].m_style )
-                {
-                    case LineDrawStyle::Style::eSolid :
-                      m_lines[i].m_line.Draw();
-                      break;
-
-                    case LineDrawStyle::Style::eStipple :
-                      m_lines[i].m_line.DrawStipple();
-                      break;
-
-                    default:
-                      m_lines[i].m_line.Draw();
-                      break;
-                }
+                lines[i].SetPattern( GLLine::c_hiddenPattern );
             }
         }
     }
@@ -188,7 +173,7 @@ public:
     // Application Module overrides.
     void Initialise();
     void Update();
-    void Draw();
+    void Draw( LineBatch& batch );
 };
 
 
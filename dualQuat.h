@@ -2,101 +2,258 @@
 #define __DUAL_QUATERNION_H__
 
 #include <assert.h>
-#include <iostream>
-#include <string>
+#include <cstddef>
 #include <cmath>
-#include <algorithm>
 #include "quat.h"
-//#include "vector3.h"
-//#include "vector4.h"
 
 namespace GrapheneMath
 {
+    // Unit dual quaternion dq = q0 + @qe, @ - dual unit, @^2 = 0.
+    // Represents a rigid transform, rotation q0 followed by translation t:
+    // qe = 1/2 t q0 and p' = q0 p q0* + t.
+    // Stored as 8 scalars, q0 then qe, each x, y, z, w like Quaternion.
     template <typename Scalar>
     class DualQuaternion
     {
       private:
-          Quaternion<Scalar> q0;
-          Quaternion<Scalar> qe;
+          enum { eQ0 = 0, eQe = 4, eNumOfScalars = 8 };
+
+          Scalar m_data[ eNumOfScalars ];
+
+          // out = a * b, quaternion product on ( x, y, z, w ) arrays,
+          // unwrapped like Quaternion::operator*.
+          static inline void Mul( const Scalar* a, const Scalar* b, Scalar* out )
+          {
+              out[0] = a[3] * b[0] + b[3] * a[0] + a[1] * b[2] - a[2] * b[1];
+              out[1] = a[3] * b[1] - a[0] * b[2] + b[3] * a[1] + a[2] * b[0];
+              out[2] = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + b[3] * a[2];
+              out[3] = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+          }
+
+          // out += a * b
+          static inline void MulAdd( const Scalar* a, const Scalar* b, Scalar* out )
+          {
+              out[0] += a[3] * b[0] + b[3] * a[0] + a[1] * b[2] - a[2] * b[1];
+              out[1] += a[3] * b[1] - a[0] * b[2] + b[3] * a[1] + a[2] * b[0];
+              out[2] += a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + b[3] * a[2];
+              out[3] += a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+          }
 
       public:
-      // Default ctor creates identity quaternions.
+      // Default ctor creates the identity transform.
       DualQuaternion()
-        : q0( Scalar(1.0), Vector3<Scalar>( 0.0, 0.0, 0.0 ) ), //< identity quaternion
-          qe( Scalar(1.0), Vector3<Scalar>( 0.0, 0.0, 0.0 ) )  //< identity quaternion
+        : m_data{ Scalar( 0.0 ), Scalar( 0.0 ), Scalar( 0.0 ), Scalar( 1.0 ),   //< identity quaternion
+                  Scalar( 0.0 ), Scalar( 0.0 ), Scalar( 0.0 ), Scalar( 0.0 ) }  //< no translation
       {}
-      
-      inline const Quaternion<Scalar> GetQ0() const { return q0; }
-      inline const Quaternion<Scalar> GetQe() const { return qe; }
-      
-  
-      /*DualQuaternion( const Quaternion& _q0, const Quaternion& _qe )
-        : q0( _q0 ), qe( _qe ) 
+
+      DualQuaternion( const Quaternion<Scalar>& _q0, const Quaternion<Scalar>& _qe )
+        : m_data{ _q0.GetX(), _q0.GetY(), _q0.GetZ(), _q0.GetW(),
+                  _qe.GetX(), _qe.GetY(), _qe.GetZ(), _qe.GetW() }
       {}
-  
+
+      inline const Quaternion<Scalar> GetQ0() const
+      {
+          return Quaternion<Scalar>( m_data[0], m_data[1], m_data[2], m_data[3] );
+      }
+
+      inline const Quaternion<Scalar> GetQe() const
+      {
+          return Quaternion<Scalar>( m_data[4], m_data[5], m_data[6], m_data[7] );
+      }
+
+      // The 8 scalars, q0 then qe.
+      const Scalar* GetData() const { return m_data; }
+
+      // Function creates dual quaternion from unit rotation quaternion and translation.
+      void FromRotationTranslation( const Quaternion<Scalar>& rot, const Vector3<Scalar>& translation );
+
       // Function creates dual quaternion form unit axis, angle (in radians) and translation.
-      inline void FromAxisAngleTranslation(
-         const Vector3& axis,
-         double         angle,
-         const Vector3& translation )
+      void FromAxisAngleTranslation( const Vector3<Scalar>& axis, Scalar angle, const Vector3<Scalar>& translation )
       {
-        //assert( abs (1.0 - axis.Magnitude() ) < MathTools::UNIT_TOLERANCE );
-      
-      q0.FromAxisAngle( axis, angle );
-      qe.FromRealPartVector( 0.0, translation * 0.5 );
-      qe = qe * q0;
-     }
-  
-  // Dual quaternion - dual quaternionMultiplication operator
-  // ( non-optimal implementation )
-  // @ - dual unit, @^2 = 0
-  // d - dual quaternion
-  // dq * dp = (q0 + @qe)(p0 + @pe) = q0p0 + @q0pe + @qep0 + @^2qepe
-  //                                = q0p0 + @(q0pe + qep0) + 0
-  //                                = q0p0 + @(q0pe + qep0)
-  inline const DualQuaternion operator*( const DualQuaternion& dp ) const
-  {
-    return DualQuaternion( q0 * dp.q0, q0 * dp.qe + qe * dp.q0 );
-  }
-  
-  // Dual quaternion - quaternion multiplication operator
-  // ( non-potimal implementation )
-  // @ - dual unit, @^2 = 0
-  // dq * p = (q0 + @qe)p = q0p + @qep
-  inline const DualQuaternion operator*( const Quaternion& p ) const
-  {
-    return DualQuaternion( q0 * p, qe * p );
-  }
-  
-  // Transform - rotates and translates input vector v using this dual quaternion.
-  Vector3 Transform( const Vector3& v )
-  {
-    // Convert vertex to dual quaternion.
-    const DualQuaternion dv( Quaternion( 1.0, Vector3( 0.0, 0.0, 0.0 ) ), // q0
-                             Quaternion( 0.0, v ) );                      // qe
-    const DualQuaternion dq = *this;
-    DualQuaternion dqCDC( dq );
-    dqCDC = dqCDC.Conjugate();
-    dqCDC = dqCDC.DualConjugate();
-    return ( dq * ( dv * dqCDC ) ).qe.v;
-  }
-  
-  // Conjugation.
-  inline const DualQuaternion Conjugate( void ) const
-  {
-    return DualQuaternion( ~q0, ~qe );
-  }
-  
-  // Dual conjugation.
-  inline const DualQuaternion DualConjugate( void ) const
-  {
-    return DualQuaternion( q0, Quaternion( qe.GetRealPart() * ( -1.0 ),
-                                           qe.GetVectorPart() * ( -1.0 ) ) );
-  }
-  */
-};
-
-  
-  
+          Quaternion<Scalar> rot;
+          rot.FromAxisAngle( axis, angle );
+          FromRotationTranslation( rot, translation );
+      }
+
+      // Translation t = 2 qe q0*.
+      const Vector3<Scalar> GetTranslation() const;
+
+      // Dual quaternion - dual quaternion multiplication operator, applies dp first.
+      // dq * dp = (q0 + @qe)(p0 + @pe) = q0p0 + @(q0pe + qep0)
+      // Three unwrapped quaternion products, no temporaries.
+      const DualQuaternion operator*( const DualQuaternion& dp ) const
+      {
+          DualQuaternion result;
+          Mul( m_data + eQ0, dp.m_data + eQ0, result.m_data + eQ0 );
+          Mul( m_data + eQ0, dp.m_data + eQe, result.m_data + eQe );
+          MulAdd( m_data + eQe, dp.m_data + eQ0, result.m_data + eQe );
+          return result;
+      }
+
+      // Dual quaternion - quaternion multiplication operator.
+      // dq * p = (q0 + @qe)p = q0p + @qep
+      const DualQuaternion operator*( const Quaternion<Scalar>& p ) const
+      {
+          const Scalar pData[4] = { p.GetX(), p.GetY(), p.GetZ(), p.GetW() };
+          DualQuaternion result;
+          Mul( m_data + eQ0, pData, result.m_data + eQ0 );
+          Mul( m_data + eQe, pData, result.m_data + eQe );
+          return result;
+      }
+
+      // Conjugation, the inverse of a unit dual quaternion.
+      const DualQuaternion Conjugate() const
+      {
+          return DualQuaternion( ~GetQ0(), ~GetQe() );
+      }
+
+      // Dual conjugation.
+      const DualQuaternion DualConjugate() const
+      {
+          DualQuaternion result = *this;
+          for( int i = eQe; i < eNumOfScalars; ++i ) {
+              result.m_data[i] = -result.m_data[i];
+          }
+          return result;
+      }
+
+      // Function makes this a unit dual quaternion: |q0| = 1 and q0 . qe = 0.
+      void Normalise();
+
+      // Function rotates v by the real part q0 and adds the translation
+      // 2 qe q0* (GetTranslation). For a unit dual quaternion this equals the
+      // sandwich dq (1 + @v) dq~.
+      const Vector3<Scalar> Transform( const Vector3<Scalar>& v ) const
+      {
+          return GetQ0().RotateFast( v ) + GetTranslation();
+      }
+
+      // Screw linear interpolation from a (t = 0) to b (t = 1) along the
+      // shortest screw motion, both unit dual quaternions.
+      static const DualQuaternion ScLERP( const DualQuaternion& a, const DualQuaternion& b, Scalar t );
+    };
+
+    template <typename Scalar>
+    void DualQuaternion<Scalar>::FromRotationTranslation( const Quaternion<Scalar>& rot, const Vector3<Scalar>& translation )
+    {
+        const Scalar halfT[4] = { Scalar( 0.5 ) * translation.GetX(),
+                                  Scalar( 0.5 ) * translation.GetY(),
+                                  Scalar( 0.5 ) * translation.GetZ(),
+                                  Scalar( 0.0 ) };
+        m_data[0] = rot.GetX(); m_data[1] = rot.GetY(); m_data[2] = rot.GetZ(); m_data[3] = rot.GetW();
+        Mul( halfT, m_data + eQ0, m_data + eQe );
+    }
+
+    // qe q0* = ( re r0 + ve . v0, r0 ve - re v0 + v0 x ve ), the real part is 0.
+    template <typename Scalar>
+    const Vector3<Scalar> DualQuaternion<Scalar>::GetTranslation() const
+    {
+        const Scalar* q0 = m_data + eQ0;
+        const Scalar* qe = m_data + eQe;
+        const Scalar TWO = Scalar( 2.0 );
+        return Vector3<Scalar>(
+            TWO * ( q0[3] * qe[0] - qe[3] * q0[0] + q0[1] * qe[2] - q0[2] * qe[1] ),
+            TWO * ( q0[3] * qe[1] - qe[3] * q0[1] + q0[2] * qe[0] - q0[0] * qe[2] ),
+            TWO * ( q0[3] * qe[2] - qe[3] * q0[2] + q0[0] * qe[1] - q0[1] * qe[0] ) );
+    }
+
+    template <typename Scalar>
+    void DualQuaternion<Scalar>::Normalise()
+    {
+        Scalar* q0 = m_data + eQ0;
+        Scalar* qe = m_data + eQe;
+        const Scalar magnitude = sqrt( q0[0] * q0[0] + q0[1] * q0[1] + q0[2] * q0[2] + q0[3] * q0[3] );
+        if( magnitude )
+        {
+            const Scalar invMagnitude = Scalar( 1.0 ) / magnitude;
+            for( int i = 0; i < eNumOfScalars; ++i ) {
+                m_data[i] *= invMagnitude;
+            }
+
+            // Remove the part of qe along q0.
+            const Scalar dot = q0[0] * qe[0] + q0[1] * qe[1] + q0[2] * qe[2] + q0[3] * qe[3];
+            for( int i = 0; i < 4; ++i ) {
+                qe[i] -= dot * q0[i];
+            }
+        }
+    }
+
+    // ScLERP(a, b, t) = a (a~ b)^t. The power of the difference is taken on its
+    // screw parameters: angle and pitch scale by t, axis and moment stay.
+    template <typename Scalar>
+    const DualQuaternion<Scalar> DualQuaternion<Scalar>::ScLERP( const DualQuaternion<Scalar>& a, const DualQuaternion<Scalar>& b, Scalar t )
+    {
+        DualQuaternion diff = a.Conjugate() * b;
+
+        // Shortest path, q and -q are the same rotation.
+        if( diff.m_data[3] < Scalar( 0.0 ) ) {
+            for( int i = 0; i < eNumOfScalars; ++i ) {
+                diff.m_data[i] = -diff.m_data[i];
+            }
+        }
+
+        const Scalar* r = diff.m_data + eQ0;
+        const Scalar* d = diff.m_data + eQe;
+        const Vector3<Scalar> rVec( r[0], r[1], r[2] );
+        const Scalar sinHalfAngle = rVec.Mag();
+
+        DualQuaternion power;
+        if( sinHalfAngle < Constants<Scalar>::NumTolerance() )
+        {
+            // (Nearly) pure translation, linear blend with the identity.
+            for( int i = 0; i < eNumOfScalars; ++i ) {
+                power.m_data[i] = ( Scalar( 1.0 ) - t ) * power.m_data[i] + t * diff.m_data[i];
+            }
+            power.Normalise();
+        }
+        else
+        {
+            const Scalar invSin = Scalar( 1.0 ) / sinHalfAngle;
+            const Vector3<Scalar> axis = rVec.ScalarMult( invSin );
+            const Scalar pitch = Scalar( -2.0 ) * d[3] * invSin;
+            const Vector3<Scalar> moment = ( Vector3<Scalar>( d[0], d[1], d[2] ) -
+                                             axis.ScalarMult( Scalar( 0.5 ) * pitch * r[3] ) ).ScalarMult( invSin );
+
+            const Scalar halfAngle = t * atan2( sinHalfAngle, r[3] );
+            const Scalar halfPitch = Scalar( 0.5 ) * t * pitch;
+            const Scalar sinH = sin( halfAngle );
+            const Scalar cosH = cos( halfAngle );
+
+            const Vector3<Scalar> real = axis.ScalarMult( sinH );
+            const Vector3<Scalar> dual = moment.ScalarMult( sinH ) + axis.ScalarMult( halfPitch * cosH );
+            power = DualQuaternion( Quaternion<Scalar>( cosH, real ), Quaternion<Scalar>( -halfPitch * sinH, dual ) );
+        }
+
+        return a * power;
+    }
+
+    // Function transforms 'count' vectors with unit dual quaternion dq:
+    // out[i] = q0(in[i]) + t. 'in' and 'out' may be the same array.
+    // The 8 scalars are expanded once into rotation columns and translation,
+    // see RotateMany.
+    template <typename Scalar>
+    void TransformMany( const DualQuaternion<Scalar>& dq,
+                        const Vector3<Scalar>* in,
+                        Vector3<Scalar>* out,
+                        size_t count )
+    {
+        RotateMany( dq.GetQ0(), in, out, count, dq.GetTranslation() );
+    }
+
+    // Batched variant for a fleet: the same model geometry (numVertices) posed by
+    // each of numPoses dual quaternions, out holds numPoses * numVertices vectors.
+    template <typename Scalar>
+    void TransformMany( const DualQuaternion<Scalar>* poses,
+                        size_t numPoses,
+                        const Vector3<Scalar>* model,
+                        size_t numVertices,
+                        Vector3<Scalar>* out )
+    {
+        for( size_t p = 0; p < numPoses; ++p )
+        {
+            TransformMany( poses[p], model, out + p * numVertices, numVertices );
+        }
+    }
+
 }  //< End of namespace GrapheneMath
 #endif //__DUAL_QUATERNION_H__
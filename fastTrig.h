@@ -0,0 +1,308 @@
+#ifndef __FAST_TRIG_H__
+#define __FAST_TRIG_H__
+
+#include <math.h>
+#include "mathUtils.h"
+#include "simdTraits.h"
+
+namespace GrapheneMath
+{
+    // Trigonometry for the navigation hot paths with a bounded error.
+    // Minimax polynomials after range reduction, max absolute error (radians for
+    // the inverse functions) measured in double over the whole domain:
+    //
+    //   accuracy    Sin, Cos    Atan, Atan2, Asin, Acos
+    //   eTrig1e4    7.0e-5      8.6e-5
+    //   eTrig1e6    6.3e-7      2.9e-7
+    //
+    // In float the rounding adds a few 1e-7. Sin and Cos keep the bound for
+    // |x| < 6000 rad in float, beyond any angle of the navigation code.
+    //
+    // The accuracy is chosen per call site, Trig<float, eTrig1e4>::Sin( x ),
+    // or for every Trig<Scalar> call site through the precision policy with
+    // GRAPHENE_FAST_TRIG: 0 the C library (default), 1 eTrig1e4, 2 eTrig1e6.
+    enum TrigAccuracy
+    {
+        eTrigLibm = 0,
+        eTrig1e4  = 1,
+        eTrig1e6  = 2
+    };
+
+#ifndef GRAPHENE_FAST_TRIG
+#define GRAPHENE_FAST_TRIG 0
+#endif
+
+#if GRAPHENE_FAST_TRIG < 0 || GRAPHENE_FAST_TRIG > 2
+#error "GRAPHENE_FAST_TRIG must be 0 (libm), 1 (1e-4) or 2 (1e-6)"
+#endif
+
+    // Polynomial cores, T is a scalar or a SIMD lane type constructible from double.
+    // sin( r ) = r * SinPoly( r^2 ),  |r| <= PI/2
+    // atan( z ) = z * AtanPoly( z^2 ), 0 <= z <= 1
+    template <int Accuracy>
+    struct TrigPolynomial;
+
+    template <>
+    struct TrigPolynomial<eTrig1e4>
+    {
+        template <typename T>
+        static inline T SinPoly( T u )
+        {
+            return T( 0.9996981912015932 ) + u * ( T( -0.16567615712500444 ) + u * T( 0.0075156279944127808 ) );
+        }
+
+        template <typename T>
+        static inline T AtanPoly( T u )
+        {
+            return T( 0.99921733617971198 ) + u * ( T( -0.32121217092446358 ) +
+                   u * ( T( 0.14635690627350231 ) + u * T( -0.039049659069743746 ) ) );
+        }
+    };
+
+    template <>
+    struct TrigPolynomial<eTrig1e6>
+    {
+        template <typename T>
+        static inline T SinPoly( T u )
+        {
+            return T( 0.99999663754895862 ) + u * ( T( -0.16664837175600924 ) +
+                   u * ( T( 0.0083064109330008018 ) + u * T( -0.0001836597347988218 ) ) );
+        }
+
+        template <typename T>
+        static inline T AtanPoly( T u )
+        {
+            return T( 0.9999961426145515 ) + u * ( T( -0.33317471606158078 ) +
+                   u * ( T( 0.19808776707543865 ) + u * ( T( -0.13237093189946431 ) +
+                   u * ( T( 0.079693798317304387 ) + u * ( T( -0.033666417451814201 ) +
+                   u * T( 0.006832809695368789 ) ) ) ) ) );
+        }
+    };
+
+    // Scalar trigonometry of the given accuracy, branch free. Compilers don't
+    // vectorise loops over it, SoA batches use TrigLanes / TrigLanesDouble.
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    struct Trig
+    {
+        typedef TrigPolynomial<Accuracy> Poly;
+
+        // PI split for the reduction, PiHi has 13 significant bits so k * PiHi is
+        // exact for |k| < 2048 even in float, PiLo is the rest.
+        static inline Scalar PiHi() { return static_cast<Scalar>( floorl( PI_L * 2048.0L ) / 2048.0L ); }
+        static inline Scalar PiLo() { return static_cast<Scalar>( PI_L - floorl( PI_L * 2048.0L ) / 2048.0L ); }
+
+        // sin( x ) = (-1)^k sin( x - k PI ), k nearest to x / PI.
+        static inline Scalar Sin( Scalar x )
+        {
+            const Scalar q  = x * ( Scalar( 1.0 ) / Constants<Scalar>::Pi() );
+            const int    k  = static_cast<int>( q + ( ( q < Scalar( 0.0 ) ) ? Scalar( -0.5 ) : Scalar( 0.5 ) ) );
+            const Scalar kf = static_cast<Scalar>( k );
+            const Scalar r  = ( x - kf * PiHi() ) - kf * PiLo();
+            const Scalar s  = r * Poly::SinPoly( r * r );
+            return ( k & 1 ) ? -s : s;
+        }
+
+        // cos( x ) = sin( x + PI/2 ), reduced as x - ( k - 1/2 ) PI.
+        static inline Scalar Cos( Scalar x )
+        {
+            const Scalar q  = x * ( Scalar( 1.0 ) / Constants<Scalar>::Pi() );
+            const int    k  = static_cast<int>( q + ( ( q < Scalar( -0.5 ) ) ? Scalar( 0.0 ) : Scalar( 1.0 ) ) );
+            const Scalar kf = static_cast<Scalar>( k ) - Scalar( 0.5 );
+            const Scalar r  = ( x - kf * PiHi() ) - kf * PiLo();
+            const Scalar s  = r * Poly::SinPoly( r * r );
+            return ( k & 1 ) ? -s : s;
+        }
+
+        // atan( x ) = PI/2 - atan( 1/x ) for |x| > 1.
+        static inline Scalar Atan( Scalar x )
+        {
+            const Scalar a   = fabs( x );
+            const bool   inv = a > Scalar( 1.0 );
+            const Scalar z   = inv ? ( Scalar( 1.0 ) / a ) : a;
+            Scalar r = z * Poly::AtanPoly( z * z );
+            r = inv ? ( Constants<Scalar>::PiOverTwo() - r ) : r;
+            return ( x < Scalar( 0.0 ) ) ? -r : r;
+        }
+
+        // Octant reduction to atan( min / max ) of |x|, |y|.
+        static inline Scalar Atan2( Scalar y, Scalar x )
+        {
+            const Scalar ax = fabs( x );
+            const Scalar ay = fabs( y );
+            const Scalar mx = ( ax > ay ) ? ax : ay;
+            const Scalar mn = ( ax > ay ) ? ay : ax;
+            const Scalar z  = ( mx > Scalar( 0.0 ) ) ? ( mn / mx ) : Scalar( 0.0 );
+            Scalar r = z * Poly::AtanPoly( z * z );
+            r = ( ay > ax ) ? ( Constants<Scalar>::PiOverTwo() - r ) : r;
+            r = ( x < Scalar( 0.0 ) ) ? ( Constants<Scalar>::Pi() - r ) : r;
+            return ( y < Scalar( 0.0 ) ) ? -r : r;
+        }
+
+        // asin( x ) = atan2( x, sqrt( 1 - x^2 ) ), the error of Atan2.
+        static inline Scalar Asin( Scalar x )
+        {
+            return Atan2( x, sqrt( ( Scalar( 1.0 ) - x ) * ( Scalar( 1.0 ) + x ) ) );
+        }
+
+        static inline Scalar Acos( Scalar x )
+        {
+            return Atan2( sqrt( ( Scalar( 1.0 ) - x ) * ( Scalar( 1.0 ) + x ) ), x );
+        }
+    };
+
+    // The C library.
+    template <typename Scalar>
+    struct Trig<Scalar, eTrigLibm>
+    {
+        static inline Scalar Sin( Scalar x )             { return sin( x ); }
+        static inline Scalar Cos( Scalar x )             { return cos( x ); }
+        static inline Scalar Atan( Scalar x )            { return atan( x ); }
+        static inline Scalar Atan2( Scalar y, Scalar x ) { return atan2( y, x ); }
+        static inline Scalar Asin( Scalar x )            { return asin( x ); }
+        static inline Scalar Acos( Scalar x )            { return acos( x ); }
+    };
+
+#if GRAPHENE_SIMD
+    // Four float lanes for the polynomial cores.
+    struct TrigLane4f
+    {
+        __m128 v;
+
+        TrigLane4f( __m128 _v ) : v( _v ) {}
+        TrigLane4f( double c ) : v( _mm_set1_ps( static_cast<float>( c ) ) ) {}
+    };
+
+    inline TrigLane4f operator+( const TrigLane4f& a, const TrigLane4f& b ) { return _mm_add_ps( a.v, b.v ); }
+    inline TrigLane4f operator*( const TrigLane4f& a, const TrigLane4f& b ) { return _mm_mul_ps( a.v, b.v ); }
+
+    // SSE version of Trig<float, Accuracy>, four arguments per call, same error.
+    template <int Accuracy>
+    struct TrigLanes
+    {
+        typedef TrigPolynomial<Accuracy> Poly;
+
+        static inline __m128 Select( __m128 mask, __m128 a, __m128 b )
+        {
+            return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+        }
+
+        // Reduced argument r = x - kf PI and the sign of (-1)^k.
+        static inline __m128 SinReduced( __m128 x, __m128 kf, __m128i k )
+        {
+            const __m128 r = _mm_sub_ps( _mm_sub_ps( x, _mm_mul_ps( kf, _mm_set1_ps( Trig<float, Accuracy>::PiHi() ) ) ),
+                                         _mm_mul_ps( kf, _mm_set1_ps( Trig<float, Accuracy>::PiLo() ) ) );
+            const __m128 s = _mm_mul_ps( r, Poly::SinPoly( TrigLane4f( _mm_mul_ps( r, r ) ) ).v );
+            return _mm_xor_ps( s, _mm_castsi128_ps( _mm_slli_epi32( k, 31 ) ) );
+        }
+
+        static inline __m128 Sin( __m128 x )
+        {
+            const __m128i k = _mm_cvtps_epi32( _mm_mul_ps( x, _mm_set1_ps( 1.0f / Constants<float>::Pi() ) ) ); //< round to nearest
+            return SinReduced( x, _mm_cvtepi32_ps( k ), k );
+        }
+
+        static inline __m128 Cos( __m128 x )
+        {
+            const __m128i k = _mm_cvtps_epi32( _mm_add_ps( _mm_mul_ps( x, _mm_set1_ps( 1.0f / Constants<float>::Pi() ) ),
+                                                           _mm_set1_ps( 0.5f ) ) );
+            return SinReduced( x, _mm_sub_ps( _mm_cvtepi32_ps( k ), _mm_set1_ps( 0.5f ) ), k );
+        }
+
+        static inline __m128 Atan2( __m128 y, __m128 x )
+        {
+            const __m128 signMask = _mm_set1_ps( -0.0f );
+            const __m128 ax = _mm_andnot_ps( signMask, x );
+            const __m128 ay = _mm_andnot_ps( signMask, y );
+            const __m128 mx = _mm_max_ps( ax, ay );
+            const __m128 mn = _mm_min_ps( ax, ay );
+            const __m128 z  = _mm_and_ps( _mm_cmpgt_ps( mx, _mm_setzero_ps() ), _mm_div_ps( mn, mx ) );
+
+            __m128 r = _mm_mul_ps( z, Poly::AtanPoly( TrigLane4f( _mm_mul_ps( z, z ) ) ).v );
+            r = Select( _mm_cmpgt_ps( ay, ax ), _mm_sub_ps( _mm_set1_ps( Constants<float>::PiOverTwo() ), r ), r );
+            r = Select( _mm_cmplt_ps( x, _mm_setzero_ps() ), _mm_sub_ps( _mm_set1_ps( Constants<float>::Pi() ), r ), r );
+            return _mm_or_ps( r, _mm_and_ps( y, signMask ) );
+        }
+
+        static inline __m128 Atan( __m128 x )
+        {
+            return Atan2( x, _mm_set1_ps( 1.0f ) );
+        }
+
+        static inline __m128 Asin( __m128 x )
+        {
+            const __m128 one = _mm_set1_ps( 1.0f );
+            return Atan2( x, _mm_sqrt_ps( _mm_mul_ps( _mm_sub_ps( one, x ), _mm_add_ps( one, x ) ) ) );
+        }
+
+        static inline __m128 Acos( __m128 x )
+        {
+            const __m128 one = _mm_set1_ps( 1.0f );
+            return Atan2( _mm_sqrt_ps( _mm_mul_ps( _mm_sub_ps( one, x ), _mm_add_ps( one, x ) ) ), x );
+        }
+    };
+
+    // Two double lanes for the polynomial cores.
+    struct TrigLane2d
+    {
+        __m128d v;
+
+        TrigLane2d( __m128d _v ) : v( _v ) {}
+        TrigLane2d( double c ) : v( _mm_set1_pd( c ) ) {}
+    };
+
+    inline TrigLane2d operator+( const TrigLane2d& a, const TrigLane2d& b ) { return _mm_add_pd( a.v, b.v ); }
+    inline TrigLane2d operator*( const TrigLane2d& a, const TrigLane2d& b ) { return _mm_mul_pd( a.v, b.v ); }
+
+    // SSE2 version of Trig<double, Accuracy>, two arguments per call, same error.
+    template <int Accuracy>
+    struct TrigLanesDouble
+    {
+        typedef TrigPolynomial<Accuracy> Poly;
+
+        static inline __m128d Select( __m128d mask, __m128d a, __m128d b )
+        {
+            return _mm_or_pd( _mm_and_pd( mask, a ), _mm_andnot_pd( mask, b ) );
+        }
+
+        // Reduced argument r = x - kf PI and the sign of (-1)^k, k in the two low int lanes.
+        static inline __m128d SinReduced( __m128d x, __m128d kf, __m128i k )
+        {
+            const __m128d r = _mm_sub_pd( _mm_sub_pd( x, _mm_mul_pd( kf, _mm_set1_pd( Trig<double, Accuracy>::PiHi() ) ) ),
+                                          _mm_mul_pd( kf, _mm_set1_pd( Trig<double, Accuracy>::PiLo() ) ) );
+            const __m128d s = _mm_mul_pd( r, Poly::SinPoly( TrigLane2d( _mm_mul_pd( r, r ) ) ).v );
+            const __m128i sign = _mm_slli_epi64( _mm_shuffle_epi32( k, _MM_SHUFFLE( 1, 1, 0, 0 ) ), 63 );
+            return _mm_xor_pd( s, _mm_castsi128_pd( sign ) );
+        }
+
+        static inline __m128d Sin( __m128d x )
+        {
+            const __m128i k = _mm_cvtpd_epi32( _mm_mul_pd( x, _mm_set1_pd( 1.0 / Constants<double>::Pi() ) ) ); //< round to nearest
+            return SinReduced( x, _mm_cvtepi32_pd( k ), k );
+        }
+
+        static inline __m128d Cos( __m128d x )
+        {
+            const __m128i k = _mm_cvtpd_epi32( _mm_add_pd( _mm_mul_pd( x, _mm_set1_pd( 1.0 / Constants<double>::Pi() ) ),
+                                                           _mm_set1_pd( 0.5 ) ) );
+            return SinReduced( x, _mm_sub_pd( _mm_cvtepi32_pd( k ), _mm_set1_pd( 0.5 ) ), k );
+        }
+
+        static inline __m128d Atan2( __m128d y, __m128d x )
+        {
+            const __m128d signMask = _mm_set1_pd( -0.0 );
+            const __m128d ax = _mm_andnot_pd( signMask, x );
+            const __m128d ay = _mm_andnot_pd( signMask, y );
+            const __m128d mx = _mm_max_pd( ax, ay );
+            const __m128d mn = _mm_min_pd( ax, ay );
+            const __m128d z  = _mm_and_pd( _mm_cmpgt_pd( mx, _mm_setzero_pd() ), _mm_div_pd( mn, mx ) );
+
+            __m128d r = _mm_mul_pd( z, Poly::AtanPoly( TrigLane2d( _mm_mul_pd( z, z ) ) ).v );
+            r = Select( _mm_cmpgt_pd( ay, ax ), _mm_sub_pd( _mm_set1_pd( Constants<double>::PiOverTwo() ), r ), r );
+            r = Select( _mm_cmplt_pd( x, _mm_setzero_pd() ), _mm_sub_pd( _mm_set1_pd( Constants<double>::Pi() ), r ), r );
+            return _mm_or_pd( r, _mm_and_pd( y, signMask ) );
+        }
+    };
+#endif // GRAPHENE_SIMD
+
+}  //< End of GrapheneMath namespace.
+#endif // __FAST_TRIG_H__
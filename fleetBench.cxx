@@ -0,0 +1,173 @@
+// Frame time of large fleets: every aircraft moves along its heading, is
+// submitted to an AeroplaneFleet and the frame is drawn and finished, with the
+// instanced path, with the per aircraft fallback forced, and against one
+// Aeroplane::Draw() per aircraft. Needs a GL context (hidden GLFW window).
+// Build and run with 'make fleetbench':
+//
+//   ./NavexFleetBench [numAircraft ...]     default 10000 50000
+
+#include <GLFW/glfw3.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "benchmark.h"
+#include "aeroplaneFleet.h"
+#include "aeroplane.h"
+
+using namespace GrapheneMath;
+
+static const int   c_width  = 800;
+static const int   c_height = 600;
+static const float c_timeStep = 1.0f / 60.0f;
+
+// Aircraft on a square grid, random headings, speed along the heading.
+template <typename Plane>
+static void PlaceFleet( std::vector<Plane>& planes, std::vector< Vector3<float> >& velocities, float& extent )
+{
+    std::mt19937 rng( 7 );
+    std::uniform_real_distribution<float> heading( 0.0f, 360.0f );
+    std::uniform_real_distribution<float> speed( 60.0f, 140.0f );
+
+    const size_t side = static_cast<size_t>( ceil( sqrt( static_cast<double>( planes.size() ) ) ) );
+    extent = 4.0f * side;
+    velocities.resize( planes.size() );
+
+    for( size_t i = 0; i < planes.size(); ++i )
+    {
+        const float hdg = heading( rng );
+        planes[i].SetHDG( hdg );
+        planes[i].SetPosition( Vector3<float>( 4.0f * ( i % side ) - 0.5f * extent, 0.0f, 4.0f * ( i / side ) - 0.5f * extent ) );
+        velocities[i] = Vector3<float>( cos( Deg2Rad( hdg ) ), 0.0f, -sin( Deg2Rad( hdg ) ) ).ScalarMult( speed( rng ) / 3600.0f );
+    }
+}
+
+static void SetView( float extent )
+{
+    glViewport( 0, 0, c_width, c_height );
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    glOrtho( -0.5 * extent, 0.5 * extent, -0.5 * extent, 0.5 * extent, -10.0, 10.0 );
+    glMatrixMode( GL_MODELVIEW );
+    glLoadIdentity();
+    glRotatef( 90.0f, 1.0f, 0.0f, 0.0f ); //< looking down the y axis
+}
+
+static void Move( AeroplaneKinematics& plane, const Vector3<float>& velocity )
+{
+    plane.SetPosition( plane.GetPosition() + velocity.ScalarMult( c_timeStep ) );
+}
+
+static double RunFleet( Benchmark::Runner& runner, size_t numAircraft, bool allowInstancing, bool& instanced )
+{
+    std::vector<AeroplaneKinematics> planes( numAircraft );
+    std::vector< Vector3<float> > velocities;
+    float extent = 0.0f;
+    PlaceFleet( planes, velocities, extent );
+    SetView( extent );
+
+    AeroplaneFleet fleet( 0.3f, numAircraft, allowInstancing );
+    const Vector3<GLfloat> color( 1.0f, 1.0f, 1.0f );
+
+    char name[64];
+    snprintf( name, sizeof( name ), "AeroplaneFleet %s %u", allowInstancing ? "instanced" : "fallback",
+              static_cast<unsigned>( numAircraft ) );
+    const Benchmark::Result& result = runner.Run( name, 1, [&]() {
+        glClear( GL_COLOR_BUFFER_BIT );
+        for( size_t i = 0; i < numAircraft; ++i )
+        {
+            Move( planes[i], velocities[i] );
+            fleet.Add( planes[i], color );
+        }
+        fleet.Flush();
+        glFinish();
+    } );
+
+    instanced = fleet.IsInstanced();
+    return result.medianNs;
+}
+
+static double RunSingles( Benchmark::Runner& runner, size_t numAircraft )
+{
+    std::vector<Aeroplane> planes( numAircraft );
+    std::vector< Vector3<float> > velocities;
+    float extent = 0.0f;
+    PlaceFleet( planes, velocities, extent );
+    SetView( extent );
+
+    char name[64];
+    snprintf( name, sizeof( name ), "Aeroplane::Draw x %u", static_cast<unsigned>( numAircraft ) );
+    const Benchmark::Result& result = runner.Run( name, 1, [&]() {
+        glClear( GL_COLOR_BUFFER_BIT );
+        for( size_t i = 0; i < numAircraft; ++i )
+        {
+            Move( planes[i], velocities[i] );
+            planes[i].Draw();
+        }
+        glFinish();
+    } );
+
+    return result.medianNs;
+}
+
+int main( int argc, char* argv[] )
+{
+    if( !glfwInit() )
+    {
+        fprintf( stderr, "Can't initialise GLFW\n" );
+        return 1;
+    }
+
+    glfwWindowHint( GLFW_VISIBLE, GLFW_FALSE );
+    GLFWwindow* window = glfwCreateWindow( c_width, c_height, "Nav EX fleet bench", NULL, NULL );
+    if( !window )
+    {
+        fprintf( stderr, "Can't create a GL context\n" );
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent( window );
+    glfwSwapInterval( 0 );
+
+    std::vector<size_t> sizes;
+    for( int i = 1; i < argc; ++i )
+    {
+        sizes.push_back( static_cast<size_t>( atol( argv[i] ) ) );
+    }
+    if( sizes.empty() )
+    {
+        sizes.push_back( 10000 );
+        sizes.push_back( 50000 );
+    }
+
+    printf( "GL %s, %s, %dx%d\n", glGetString( GL_VERSION ), glGetString( GL_RENDERER ), c_width, c_height );
+    printf( "%-12s %14s %14s %14s\n", "aircraft", "instanced ms", "fallback ms", "singles ms" );
+
+    {
+        Benchmark::Runner runner( 3, 20 );
+        for( size_t i = 0; i < sizes.size(); ++i )
+        {
+            bool instanced = false;
+            bool fallbackInstanced = false;
+            const double instancedNs = RunFleet( runner, sizes[i], true, instanced );
+            const double fallbackNs  = RunFleet( runner, sizes[i], false, fallbackInstanced );
+            const double singlesNs   = RunSingles( runner, sizes[i] );
+            assert( !fallbackInstanced );
+
+            // Below GL 3.3 both fleets take the fallback.
+            char instancedMs[32] = "n/a";
+            if( instanced )
+            {
+                snprintf( instancedMs, sizeof( instancedMs ), "%.2f", instancedNs * 1e-6 );
+            }
+            printf( "%-12u %14s %14.2f %14.2f\n", static_cast<unsigned>( sizes[i] ),
+                    instancedMs, fallbackNs * 1e-6, singlesNs * 1e-6 );
+        }
+    }
+
+    glfwDestroyWindow( window );
+    glfwTerminate();
+    return 0;
+}
@@ -2,6 +2,7 @@
 #define __GLLINE_H__
 
 #include <assert.h>
+#include <type_traits>
 
 #include <GLFW/glfw3.h>
 //#include "mathUtils.h" //< Graphene Math v.11
@@ -9,91 +10,85 @@
 
 using namespace GrapheneMath;
 
+// One end of a line as the GPU reads it, position, colour and the stipple
+// pattern of the line (16 bits as for glLineStipple, held exactly in a float).
+struct LineVertex
+{
+  GLfloat pos[3];
+  GLfloat color[3];
+  GLfloat pattern;
+};
+
 // Color line for debug drawing.
+// POD of two packed vertices, no heap allocation, and laid out exactly like
+// two vertices of the LineBatch vertex buffer so arrays of lines are copied
+// to it as they are. GLLine() value-initialised ( GLLine x = GLLine(); or
+// std::vector resize ) is the zero line, hidden.
 class GLLine
 {
 private:
-  static const unsigned int dim = 3; 
-  
-  std::vector< GLfloat > from;
-  std::vector< GLfloat > to;
-  std::vector< GLfloat > color;
-  
-  inline void Initialize()
-  {
-    from.resize( dim );
-    to.resize( dim );
-    color.resize( dim );
-  }
+  LineVertex m_vertices[2]; //< from, to; colour and pattern are stored at both ends.
 
 public:
-  explicit GLLine()
-  {
-    Initialize();
-    const Vector3< GLfloat > zero(0.0, 0.0, 0.0);
-    Set( zero, zero, zero );
-  }
-  
-  explicit GLLine( const Vector3< GLfloat >& from,
-                   const Vector3< GLfloat >& to,
-                   const Vector3< GLfloat >& color)
+  static const GLushort c_solidPattern  = 0xFFFF;
+  static const GLushort c_hiddenPattern = 0;      //< submitted, but not drawn
+
+  GLLine() = default;
+
+  GLLine( const Vector3< GLfloat >& from,
+          const Vector3< GLfloat >& to,
+          const Vector3< GLfloat >& color )
   {
-    Initialize();
     Set( from, to, color );
   }
   
   inline void SetFrom( const Vector3< GLfloat >& from )
   {
-    GLLine* const line = this;
-    line->from[0] = from.GetX();
-    line->from[1] = from.GetY();
-    line->from[2] = from.GetZ();
+    m_vertices[0].pos[0] = from.GetX();
+    m_vertices[0].pos[1] = from.GetY();
+    m_vertices[0].pos[2] = from.GetZ();
   }
   
   inline void SetTo(const Vector3<GLfloat>& to)
   {
-    GLLine* const line = this;
-    line->to[0] = to.GetX();
-    line->to[1] = to.GetY();
-    line->to[2] = to.GetZ();
+    m_vertices[1].pos[0] = to.GetX();
+    m_vertices[1].pos[1] = to.GetY();
+    m_vertices[1].pos[2] = to.GetZ();
   }
   
   inline void SetColor(const Vector3<GLfloat>& color)
   {
-    GLLine* const line = this;
-    line->color[0] = color.GetX();
-    line->color[1] = color.GetY();
-    line->color[2] = color.GetZ();
+    for( int i = 0; i < 2; ++i )
+    {
+      m_vertices[i].color[0] = color.GetX();
+      m_vertices[i].color[1] = color.GetY();
+      m_vertices[i].color[2] = color.GetZ();
+    }
   }
     
-  void Set(const Vector3<GLfloat>& from, const Vector3<GLfloat>& to, const Vector3<GLfloat>& color)
+  inline void SetPattern( GLushort pattern )
   {
-    GLLine* const line = this;
-    line->SetFrom( from );
-    line->SetTo( to );
-    line->SetColor( color );
+    m_vertices[0].pattern = pattern;
+    m_vertices[1].pattern = pattern;
   }
-  
-  inline Vector3< GLfloat > GetFrom() { return Vector3<GLfloat>(from[0], from[1], from[2]); }
-  inline Vector3< GLfloat > GetTo() { return Vector3<GLfloat>(to[0], to[1], to[2]); }
-  
-  void Draw() const
+
+  // A solid line.
+  void Set(const Vector3<GLfloat>& from, const Vector3<GLfloat>& to, const Vector3<GLfloat>& color)
   {
-    glColor3f( color[0], color[1], color[2] );
-    glBegin( GL_LINES );
-    glVertex3f( from[0], from[1], from[2] );
-    glVertex3f( to[0], to[1], to[2] );
-    glEnd();
+    SetFrom( from );
+    SetTo( to );
+    SetColor( color );
+    SetPattern( c_solidPattern );
   }
   
-  void DrawStipple() const
-  {
-    glLineStipple( 4, 0xAAAA );
-    glEnable(GL_LINE_STIPPLE);
-
-    Draw();
+  inline Vector3< GLfloat > GetFrom() const { return Vector3<GLfloat>( m_vertices[0].pos[0], m_vertices[0].pos[1], m_vertices[0].pos[2] ); }
+  inline Vector3< GLfloat > GetTo() const { return Vector3<GLfloat>( m_vertices[1].pos[0], m_vertices[1].pos[1], m_vertices[1].pos[2] ); }
+  inline GLushort GetPattern() const { return static_cast<GLushort>( m_vertices[0].pattern ); }
 
-    glDisable(GL_LINE_STIPPLE);
-  }
+  const LineVertex* GetVertices() const { return m_vertices; }
 };
+
+static_assert( std::is_pod<GLLine>::value, "GLLine is copied to the vertex buffer as raw memory" );
+static_assert( sizeof( GLLine ) == 2 * sizeof( LineVertex ), "GLLine is two packed vertices" );
+
 #endif //__GLLINE_H__
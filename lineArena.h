@@ -0,0 +1,59 @@
+#ifndef __LINE_ARENA_H__
+#define __LINE_ARENA_H__
+
+#include <assert.h>
+#include <cstddef>
+#include <vector>
+
+#include "glLine.h"
+
+// Per-frame bump allocator of transient lines.
+// Allocate() hands out the next 'count' contiguous lines, Reset() at the end
+// of the frame takes all of them back at once. The storage only grows, when a
+// frame needs more lines than any frame before, so a steady state frame does
+// no heap allocation.
+//
+// Lines returned by Allocate() are valid until the next Allocate() or Reset(),
+// a growth moves them.
+class LineArena
+{
+private:
+    std::vector<GLLine> m_storage; //< capacity, only ever grows
+    size_t              m_size;    //< lines allocated this frame
+
+    void Grow( size_t minSize )
+    {
+        size_t capacity = m_storage.size() > 0 ? 2 * m_storage.size() : 64;
+        while( capacity < minSize )
+        {
+            capacity *= 2;
+        }
+        m_storage.resize( capacity );
+    }
+
+public:
+    explicit LineArena( size_t capacity = 0 )
+        : m_storage( capacity )
+        , m_size( 0 )
+    {}
+
+    inline GLLine* Allocate( size_t count )
+    {
+        if( m_size + count > m_storage.size() )
+        {
+            Grow( m_size + count );
+        }
+        GLLine* const lines = m_storage.data() + m_size;
+        m_size += count;
+        return lines;
+    }
+
+    void Reset() { m_size = 0; }
+
+    // The lines allocated this frame, contiguous.
+    const GLLine* GetData() const { return m_storage.data(); }
+    size_t GetSize() const { return m_size; }
+    size_t GetCapacity() const { return m_storage.size(); }
+};
+
+#endif //__LINE_ARENA_H__
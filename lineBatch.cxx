@@ -0,0 +1,407 @@
+// Buffer storage, fences, buffer objects and shaders are called directly,
+// libGL exports them on the platforms this builds on.
+#define GL_GLEXT_PROTOTYPES
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include "lineBatch.h"
+
+namespace
+{
+    const char* const c_vertexShader =
+        "#version 150 compatibility\n"
+        "in float a_pattern;\n"
+        "out vec4 vs_color;\n"
+        "out float vs_pattern;\n"
+        "void main()\n"
+        "{\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+        "    vs_color = gl_Color;\n"
+        "    vs_pattern = a_pattern;\n"
+        "}\n";
+
+    // Hidden lines are dropped here, the others get their length in pixels.
+    const char* const c_geometryShader =
+        "#version 150 compatibility\n"
+        "layout( lines ) in;\n"
+        "layout( line_strip, max_vertices = 2 ) out;\n"
+        "uniform vec2 u_halfViewport;\n"
+        "in vec4 vs_color[];\n"
+        "in float vs_pattern[];\n"
+        "out vec4 gs_color;\n"
+        "noperspective out float gs_pixel;\n"
+        "flat out int gs_pattern;\n"
+        "void main()\n"
+        "{\n"
+        "    if( vs_pattern[0] == 0.0 ) return;\n"
+        "    vec2 a = gl_in[0].gl_Position.xy / gl_in[0].gl_Position.w * u_halfViewport;\n"
+        "    vec2 b = gl_in[1].gl_Position.xy / gl_in[1].gl_Position.w * u_halfViewport;\n"
+        "    for( int i = 0; i < 2; ++i )\n"
+        "    {\n"
+        "        gl_Position = gl_in[i].gl_Position;\n"
+        "        gs_color = vs_color[i];\n"
+        "        gs_pixel = ( i == 0 ) ? 0.0 : distance( a, b );\n"
+        "        gs_pattern = int( vs_pattern[0] );\n"
+        "        EmitVertex();\n"
+        "    }\n"
+        "    EndPrimitive();\n"
+        "}\n";
+
+    // Bit 0 of the pattern first, as glLineStipple.
+    const char* const c_fragmentShader =
+        "#version 150 compatibility\n"
+        "uniform float u_factor;\n"
+        "in vec4 gs_color;\n"
+        "noperspective in float gs_pixel;\n"
+        "flat in int gs_pattern;\n"
+        "void main()\n"
+        "{\n"
+        "    int bit = int( mod( gs_pixel / u_factor, 16.0 ) );\n"
+        "    if( ( gs_pattern & ( 1 << bit ) ) == 0 ) discard;\n"
+        "    gl_FragColor = gs_color;\n"
+        "}\n";
+
+    GLuint CompileShader( GLenum type, const char* source )
+    {
+        const GLuint shader = glCreateShader( type );
+        glShaderSource( shader, 1, &source, NULL );
+        glCompileShader( shader );
+
+        GLint compiled = GL_FALSE;
+        glGetShaderiv( shader, GL_COMPILE_STATUS, &compiled );
+        if( !compiled )
+        {
+            char log[512];
+            glGetShaderInfoLog( shader, sizeof( log ), NULL, log );
+            fprintf( stderr, "LineBatch: shader compilation failed: %s\n", log );
+            glDeleteShader( shader );
+            return 0;
+        }
+        return shader;
+    }
+}
+
+LineBatch::LineBatch( size_t expectedLines )
+    : m_path( eUninitialised )
+    , m_vbo( 0 )
+    , m_mapped( NULL )
+    , m_regionCapacity( 2 * ( expectedLines > 0 ? expectedLines : 1 ) )
+    , m_region( 0 )
+    , m_program( 0 )
+    , m_viewportLocation( -1 )
+{
+    for( unsigned i = 0; i < c_numRegions; ++i )
+    {
+        m_fences[i] = NULL;
+    }
+    m_lines[ eSolid ].Allocate( expectedLines );
+    m_lines[ eSolid ].Reset();
+}
+
+LineBatch::~LineBatch()
+{
+    DestroyBuffer();
+    if( m_program )
+    {
+        glDeleteProgram( m_program );
+    }
+}
+
+// Persistent mapping needs GL 4.4 or ARB_buffer_storage, the stipple shaders
+// GL 3.2.
+void LineBatch::SelectPath()
+{
+    int major = 0;
+    int minor = 0;
+    const char* version = reinterpret_cast<const char*>( glGetString( GL_VERSION ) );
+    if( version )
+    {
+        sscanf( version, "%d.%d", &major, &minor );
+    }
+
+    bool bufferStorage = ( major > 4 ) || ( major == 4 && minor >= 4 );
+    if( !bufferStorage )
+    {
+        const char* extensions = reinterpret_cast<const char*>( glGetString( GL_EXTENSIONS ) );
+        bufferStorage = extensions && strstr( extensions, "GL_ARB_buffer_storage" );
+    }
+
+    m_path = ( bufferStorage && CreateBuffer( m_regionCapacity ) ) ? ePersistentBuffer : eClientArrays;
+
+    if( ( major > 3 ) || ( major == 3 && minor >= 2 ) )
+    {
+        CreateProgram();
+    }
+}
+
+bool LineBatch::CreateProgram()
+{
+    const GLuint shaders[] =
+    {
+        CompileShader( GL_VERTEX_SHADER, c_vertexShader ),
+        CompileShader( GL_GEOMETRY_SHADER, c_geometryShader ),
+        CompileShader( GL_FRAGMENT_SHADER, c_fragmentShader )
+    };
+    const size_t numShaders = sizeof( shaders ) / sizeof( shaders[0] );
+
+    bool compiled = true;
+    for( size_t i = 0; i < numShaders; ++i )
+    {
+        compiled = compiled && shaders[i];
+    }
+
+    if( compiled )
+    {
+        m_program = glCreateProgram();
+        for( size_t i = 0; i < numShaders; ++i )
+        {
+            glAttachShader( m_program, shaders[i] );
+        }
+        glBindAttribLocation( m_program, c_patternAttrib, "a_pattern" );
+        glLinkProgram( m_program );
+    }
+
+    // Owned by the program from here on.
+    for( size_t i = 0; i < numShaders; ++i )
+    {
+        glDeleteShader( shaders[i] );
+    }
+
+    if( !m_program )
+    {
+        return false;
+    }
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv( m_program, GL_LINK_STATUS, &linked );
+    if( !linked )
+    {
+        char log[512];
+        glGetProgramInfoLog( m_program, sizeof( log ), NULL, log );
+        fprintf( stderr, "LineBatch: program link failed: %s\n", log );
+        glDeleteProgram( m_program );
+        m_program = 0;
+        return false;
+    }
+
+    m_viewportLocation = glGetUniformLocation( m_program, "u_halfViewport" );
+    glUseProgram( m_program );
+    glUniform1f( glGetUniformLocation( m_program, "u_factor" ), static_cast<GLfloat>( c_stippleFactor ) );
+    glUseProgram( 0 );
+    return true;
+}
+
+bool LineBatch::CreateBuffer( size_t regionCapacity )
+{
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = static_cast<GLsizeiptr>( sizeof( LineVertex ) * regionCapacity * c_numRegions );
+
+    glGenBuffers( 1, &m_vbo );
+    glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+    glBufferStorage( GL_ARRAY_BUFFER, size, NULL, flags );
+    m_mapped = static_cast<LineVertex*>( glMapBufferRange( GL_ARRAY_BUFFER, 0, size, flags ) );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    if( !m_mapped )
+    {
+        DestroyBuffer();
+        return false;
+    }
+
+    m_regionCapacity = regionCapacity;
+    m_region = 0;
+    return true;
+}
+
+void LineBatch::DestroyBuffer()
+{
+    for( unsigned i = 0; i < c_numRegions; ++i )
+    {
+        if( m_fences[i] )
+        {
+            glDeleteSync( m_fences[i] );
+            m_fences[i] = NULL;
+        }
+    }
+
+    if( m_vbo )
+    {
+        if( m_mapped )
+        {
+            glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+            glUnmapBuffer( GL_ARRAY_BUFFER );
+            glBindBuffer( GL_ARRAY_BUFFER, 0 );
+            m_mapped = NULL;
+        }
+        glDeleteBuffers( 1, &m_vbo );
+        m_vbo = 0;
+    }
+}
+
+// Blocks until the GPU has read the region, c_numRegions frames ago.
+void LineBatch::WaitForRegion( unsigned region )
+{
+    if( m_fences[ region ] )
+    {
+        const GLuint64 timeoutNs = 1000000;
+        while( glClientWaitSync( m_fences[ region ], GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs ) == GL_TIMEOUT_EXPIRED )
+        {
+        }
+        glDeleteSync( m_fences[ region ] );
+        m_fences[ region ] = NULL;
+    }
+}
+
+// Vertex, colour and, with the shaders, pattern arrays at 'vertices': a byte
+// offset into the bound buffer, or client memory.
+void LineBatch::SetPointers( uintptr_t vertices ) const
+{
+    glVertexPointer( 3, GL_FLOAT, sizeof( LineVertex ), reinterpret_cast<const GLvoid*>( vertices + offsetof( LineVertex, pos ) ) );
+    glColorPointer( 3, GL_FLOAT, sizeof( LineVertex ), reinterpret_cast<const GLvoid*>( vertices + offsetof( LineVertex, color ) ) );
+    if( m_program )
+    {
+        glVertexAttribPointer( c_patternAttrib, 1, GL_FLOAT, GL_FALSE, sizeof( LineVertex ),
+                               reinterpret_cast<const GLvoid*>( vertices + offsetof( LineVertex, pattern ) ) );
+    }
+}
+
+// Fixed function: one draw and one glLineStipple per run of lines with the
+// same pattern, hidden runs skipped. 'first' is the arena's first vertex.
+void LineBatch::DrawStippleRuns( const LineArena& lines, GLint first ) const
+{
+    const GLLine* const data = lines.GetData();
+    const GLint numLines = static_cast<GLint>( lines.GetSize() );
+
+    GLint begin = 0;
+    while( begin < numLines )
+    {
+        const GLushort pattern = data[ begin ].GetPattern();
+        GLint end = begin + 1;
+        while( end < numLines && data[ end ].GetPattern() == pattern )
+        {
+            ++end;
+        }
+
+        if( pattern == GLLine::c_solidPattern )
+        {
+            glDrawArrays( GL_LINES, first + 2 * begin, 2 * ( end - begin ) );
+        }
+        else if( pattern != GLLine::c_hiddenPattern )
+        {
+            glLineStipple( c_stippleFactor, pattern );
+            glEnable( GL_LINE_STIPPLE );
+            glDrawArrays( GL_LINES, first + 2 * begin, 2 * ( end - begin ) );
+            glDisable( GL_LINE_STIPPLE );
+        }
+        begin = end;
+    }
+}
+
+void LineBatch::Flush()
+{
+    if( m_path == eUninitialised )
+    {
+        SelectPath();
+    }
+
+    // In vertices, two per line.
+    const size_t numSolid   = 2 * m_lines[ eSolid ].GetSize();
+    const size_t numStipple = 2 * m_lines[ eStipple ].GetSize();
+    const size_t numTotal   = numSolid + numStipple;
+    if( numTotal == 0 )
+    {
+        return;
+    }
+
+    // Immutable storage, a bigger frame needs a new buffer.
+    if( m_path == ePersistentBuffer && numTotal > m_regionCapacity )
+    {
+        glFinish();
+        DestroyBuffer();
+        size_t capacity = m_regionCapacity;
+        while( capacity < numTotal )
+        {
+            capacity *= 2;
+        }
+        if( !CreateBuffer( capacity ) )
+        {
+            m_path = eClientArrays;
+        }
+    }
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_COLOR_ARRAY );
+    if( m_program )
+    {
+        GLint viewport[4];
+        glGetIntegerv( GL_VIEWPORT, viewport );
+
+        glUseProgram( m_program );
+        glUniform2f( m_viewportLocation, 0.5f * viewport[2], 0.5f * viewport[3] );
+        glEnableVertexAttribArray( c_patternAttrib );
+    }
+
+    if( m_path == ePersistentBuffer )
+    {
+        WaitForRegion( m_region );
+
+        const size_t regionStart = m_region * m_regionCapacity;
+        LineVertex* const dst = m_mapped + regionStart;
+        if( numSolid )
+        {
+            memcpy( dst, m_lines[ eSolid ].GetData(), numSolid * sizeof( LineVertex ) );
+        }
+        if( numStipple )
+        {
+            memcpy( dst + numSolid, m_lines[ eStipple ].GetData(), numStipple * sizeof( LineVertex ) );
+        }
+
+        glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+        SetPointers( regionStart * sizeof( LineVertex ) );
+        if( m_program )
+        {
+            glDrawArrays( GL_LINES, 0, static_cast<GLsizei>( numTotal ) );
+        }
+        else
+        {
+            DrawStippleRuns( m_lines[ eSolid ], 0 );
+            DrawStippleRuns( m_lines[ eStipple ], static_cast<GLint>( numSolid ) );
+        }
+        glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+        m_fences[ m_region ] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+        m_region = ( m_region + 1 ) % c_numRegions;
+    }
+    else
+    {
+        for( int style = eSolid; style < eNumStyles; ++style )
+        {
+            const LineArena& lines = m_lines[ style ];
+            if( lines.GetSize() )
+            {
+                SetPointers( reinterpret_cast<uintptr_t>( lines.GetData()->GetVertices() ) );
+                if( m_program )
+                {
+                    glDrawArrays( GL_LINES, 0, static_cast<GLsizei>( 2 * lines.GetSize() ) );
+                }
+                else
+                {
+                    DrawStippleRuns( lines, 0 );
+                }
+            }
+        }
+    }
+
+    if( m_program )
+    {
+        glDisableVertexAttribArray( c_patternAttrib );
+        glUseProgram( 0 );
+    }
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+
+    // Keeps the capacity for the next frame.
+    m_lines[ eSolid ].Reset();
+    m_lines[ eStipple ].Reset();
+}
@@ -0,0 +1,131 @@
+#ifndef __LINE_BATCH_H__
+#define __LINE_BATCH_H__
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+
+#include <GLFW/glfw3.h>
+#include <GL/glext.h>
+
+#include "vector3.h"
+#include "glLine.h"
+#include "lineArena.h"
+
+using namespace GrapheneMath;
+
+// Gathers every debug line of a frame and draws them with one glDrawArrays,
+// instead of glBegin/glEnd per line.
+//
+// Modules submit with Add() from their Draw( LineBatch& ), the application
+// calls Flush() once per frame. The lines are gathered in a per-frame arena
+// (LineArena), no heap allocation in steady state, and their vertices
+// (GLLine, position + colour + stipple pattern, tightly packed) are copied as
+// they are to a persistently mapped vertex buffer (GL 4.4 or
+// ARB_buffer_storage) split in c_numRegions regions fenced frame by frame, so
+// the CPU never waits for the GPU reading the previous frames. Without buffer
+// storage the same single draw goes through client side vertex arrays.
+//
+// The style is the per-vertex stipple pattern: a geometry shader (GL 3.2)
+// measures each line in window pixels and the fragment shader discards the
+// off bits, so solid, stippled and hidden lines go in the same draw with no
+// state change. Without the shaders glLineStipple is set for each run of lines
+// with the same pattern; solid and patterned lines are gathered apart so that
+// the runs stay few.
+class LineBatch
+{
+public:
+    enum Style
+    {
+        eSolid = 0,
+        eStipple,
+        eNumStyles
+    };
+
+private:
+    enum Path
+    {
+        eUninitialised = 0,
+        ePersistentBuffer,
+        eClientArrays
+    };
+
+    static const unsigned c_numRegions = 3; //< frames in flight
+    static const GLuint   c_patternAttrib = 6; //< generic attribute no conventional one aliases
+
+    LineArena           m_lines[ eNumStyles ]; //< submitted this frame, solid and patterned
+    Path                m_path;
+    GLuint              m_vbo;
+    LineVertex*         m_mapped;          //< whole buffer, c_numRegions regions
+    size_t              m_regionCapacity;  //< vertices per region
+    unsigned            m_region;          //< region written this frame
+    GLsync              m_fences[ c_numRegions ];
+    GLuint              m_program;         //< stipple shaders, 0 for glLineStipple
+    GLint               m_viewportLocation;
+
+    void SelectPath();
+    bool CreateProgram();
+    bool CreateBuffer( size_t regionCapacity );
+    void DestroyBuffer();
+    void WaitForRegion( unsigned region );
+    void SetPointers( uintptr_t vertices ) const;
+    void DrawStippleRuns( const LineArena& lines, GLint first ) const;
+
+    // Non-copyable, owns GL objects.
+    LineBatch( const LineBatch& );
+    LineBatch& operator=( const LineBatch& );
+
+public:
+    // Pixels per pattern bit, as the factor of glLineStipple.
+    static const GLint c_stippleFactor = 4;
+
+    static GLushort GetPattern( Style style )
+    {
+        assert( style < eNumStyles );
+        return ( style == eStipple ) ? 0xAAAA : GLLine::c_solidPattern;
+    }
+
+    // 'expectedLines' sizes the solid line arena and the first vertex buffer,
+    // both grow on demand.
+    explicit LineBatch( size_t expectedLines = 1024 );
+    ~LineBatch();
+
+    // Drawn with the line's own pattern.
+    inline void Add( const GLLine& line )
+    {
+        const Style style = ( line.GetPattern() == GLLine::c_solidPattern ) ? eSolid : eStipple;
+        *m_lines[ style ].Allocate( 1 ) = line;
+    }
+
+    inline void Add( const Vector3<GLfloat>& from,
+                     const Vector3<GLfloat>& to,
+                     const Vector3<GLfloat>& color,
+                     Style style = eSolid )
+    {
+        GLLine* const line = m_lines[ style ].Allocate( 1 );
+        line->Set( from, to, color );
+        line->SetPattern( GetPattern( style ) );
+    }
+
+    // Transient lines written in place, e.g. a whole model outline: returns
+    // 'count' lines to Set(), valid until the next Add or Flush. 'style' is
+    // the one most of them will have, any pattern is drawn right.
+    inline GLLine* AddLines( size_t count, Style style = eSolid )
+    {
+        assert( style < eNumStyles );
+        return m_lines[ style ].Allocate( count );
+    }
+
+    size_t GetNumLines() const
+    {
+        return m_lines[ eSolid ].GetSize() + m_lines[ eStipple ].GetSize();
+    }
+
+    bool IsPersistentlyMapped() const { return m_path == ePersistentBuffer; }
+
+    // Draws the lines submitted since the last Flush() and starts a new frame.
+    // Needs the GL context current, the first call picks the path.
+    void Flush();
+};
+
+#endif //__LINE_BATCH_H__
@@ -0,0 +1,591 @@
+// GrapheneMath: speed of the vector and quaternion code in the per-aircraft
+// update and render model loops. Build and run with 'make mathbench'.
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmark.h"
+#include "vector3.h"
+#include "vector4.h"
+#include "quat.h"
+#include "matrix4.h"
+#include "dualQuat.h"
+#include "vectorExpr.h"
+#include "fastTrig.h"
+
+using namespace GrapheneMath;
+
+// Per-aircraft state of the simulation update (see Simulation::Update()).
+template <typename Vec>
+struct Fleet
+{
+    std::vector<Vec> air;  //< air vector (kts)
+    std::vector<Vec> pos;  //< position (NM)
+    std::vector<Vec> vel;  //< ground vector (kts)
+    std::vector<Vec> side; //< lateral axis
+    std::vector<float> dist; //< distance flown (NM)
+
+    explicit Fleet( size_t count )
+        : air( count ), pos( count ), vel( count ), side( count ), dist( count, 0.0f )
+    {
+        std::mt19937 rng( 11 );
+        std::uniform_real_distribution<float> unit( -1.0f, 1.0f );
+        for( size_t i = 0; i < count; ++i ) {
+            air[i] = Vec( 100.0f * unit( rng ), 0.0f, 100.0f * unit( rng ) );
+        }
+    }
+};
+
+// One frame: ground vector = air vector + wind, GS, track relative to North,
+// lateral axis and position update.
+template <typename Vec>
+static void UpdateFleet( Fleet<Vec>& fleet, const Vec& wind, float dtHours )
+{
+    const Vec north( 1.0f, 0.0f, 0.0f );
+    const Vec up( 0.0f, 1.0f, 0.0f );
+    const size_t count = fleet.air.size();
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        const Vec v = fleet.air[i] + wind;
+        Vec dir = v;
+        dir.Normalise();
+
+        Vec side = dir.Cross( up );
+        side = side.ScalarMult( ( dir.Dot( north ) < 0.0f ) ? -1.0f : 1.0f );
+
+        fleet.vel[i]  = v;
+        fleet.side[i] = side;
+        fleet.pos[i] += v.ScalarMult( dtHours );
+        fleet.dist[i] += v.Mag() * dtHours;
+    }
+}
+
+template <typename Vec>
+static double RunFleet( size_t count, unsigned frames )
+{
+    Fleet<Vec> fleet( count );
+    const Vec wind( -20.0f, 0.0f, 12.0f );
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        UpdateFleet( fleet, wind, 1.0f / 216000.0f );
+        Benchmark::ClobberMemory();
+    }
+    const double ns = timer.ElapsedNs();
+    Benchmark::DoNotOptimize( fleet.pos[ count / 2 ] );
+    return ns / ( static_cast<double>( frames ) * count );
+}
+
+// Vector4 blend as used for per-vertex colour and homogeneous points.
+template <typename Vec>
+static double RunVector4( size_t count, unsigned frames )
+{
+    std::vector<Vec> a( count, Vec( 0.1f, 0.2f, 0.3f, 1.0f ) );
+    std::vector<Vec> b( count, Vec( 0.9f, 0.8f, 0.7f, 1.0f ) );
+    float sum = 0.0f;
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            a[i] = a[i] + ( b[i] - a[i] ).ScalarMult( 0.25f );
+            sum += a[i].Dot( b[i] );
+        }
+        Benchmark::ClobberMemory();
+    }
+    const double ns = timer.ElapsedNs();
+    Benchmark::DoNotOptimize( sum );
+    return ns / ( static_cast<double>( frames ) * count );
+}
+
+// Vertex array transform of the render model: every outline vertex rotated
+// twice (from/to of each line) with RotateFast, against once with RotateMany.
+template <typename Scalar>
+static void RunRotate( size_t count, unsigned frames, double& perVertexNs, double& manyNs )
+{
+    typedef Vector3<Scalar> Vec;
+    std::vector<Vec> local( count ), global( count );
+    for( size_t i = 0; i < count; ++i ) {
+        local[i] = Vec( Scalar( i % 7 ), Scalar( 0.5 ), Scalar( i % 5 ) );
+    }
+
+    Quaternion<Scalar> orient;
+    orient.FromAxisAngle( Vec( Scalar( 0.0 ), Scalar( -1.0 ), Scalar( 0.0 ) ), Scalar( 0.3 ) );
+    const Vec pos( Scalar( 10.0 ), Scalar( 2.0 ), Scalar( -3.0 ) );
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            Vec from = orient.RotateFast( local[ i ] );
+            Vec to   = orient.RotateFast( local[ ( i + 1 ) % count ] );
+            from += pos;
+            to   += pos;
+            global[ i ] = from + to;
+        }
+        Benchmark::ClobberMemory();
+    }
+    perVertexNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+
+    timer.Start();
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        RotateMany( orient, &local[0], &global[0], count, pos );
+        Benchmark::ClobberMemory();
+    }
+    manyNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+    Benchmark::DoNotOptimize( global[ count / 2 ] );
+}
+
+// Whole-array expressions, pos = pos + vel * dt and out = a + ( b - a ) * t:
+// one pass and one intermediate array per operator, against the single
+// fused pass of Expr::Assign.
+template <typename Vec>
+static void RunArrayExpr( size_t count, unsigned frames, double& perOpNs, double& fusedNs )
+{
+    typedef typename Expr::ScalarOf<Vec>::Type Scalar;
+    std::vector<Vec> pos( count ), vel( count ), a( count ), b( count ), tmp( count ), out( count );
+    for( size_t i = 0; i < count; ++i ) {
+        vel[i] = Vec( Scalar( i % 7 ), Scalar( 0.5 ), Scalar( i % 5 ) );
+        b[i]   = Vec( Scalar( 1.0 ), Scalar( i % 3 ), Scalar( 2.0 ) );
+    }
+    const Scalar dt = Scalar( 1.0 / 216000.0 );
+    const Scalar t  = Scalar( 0.25 );
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        for( size_t i = 0; i < count; ++i ) { tmp[i] = vel[i].ScalarMult( dt ); }
+        for( size_t i = 0; i < count; ++i ) { pos[i] += tmp[i]; }
+        for( size_t i = 0; i < count; ++i ) { tmp[i] = b[i] - a[i]; }
+        for( size_t i = 0; i < count; ++i ) { tmp[i] = tmp[i].ScalarMult( t ); }
+        for( size_t i = 0; i < count; ++i ) { out[i] = a[i] + tmp[i]; }
+        Benchmark::ClobberMemory();
+    }
+    perOpNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+
+    timer.Start();
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        Expr::Assign( &pos[0], count, Expr::Array( &pos[0] ) + Expr::Array( &vel[0] ) * dt );
+        Expr::Assign( &out[0], count, Expr::Array( &a[0] ) + ( Expr::Array( &b[0] ) - Expr::Array( &a[0] ) ) * t );
+        Benchmark::ClobberMemory();
+    }
+    fusedNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+    Benchmark::DoNotOptimize( pos[ count / 2 ] );
+    Benchmark::DoNotOptimize( out[ count / 2 ] );
+}
+
+// 4x4 products view * model[i] over a fleet, portable kernel against
+// Matrix4::operator* (SIMD kernel). Note GCC 12 at -O2 already vectorises
+// the portable loop for float, build with -fno-tree-vectorize to compare.
+template <typename Scalar>
+static void RunMatrixMultiply( size_t count, unsigned frames, double& portableNs, double& simdNs )
+{
+    Quaternion<Scalar> q;
+    q.FromAxisAngle( Vector3<Scalar>( Scalar( 0.0 ), Scalar( -1.0 ), Scalar( 0.0 ) ), Scalar( 0.3 ) );
+    Matrix4<Scalar> view;
+    view.CalculateTransformMatrix( Vector4<Scalar>( Scalar( 0.1 ), Scalar( 0.0 ), Scalar( 0.2 ), Scalar( 1.0 ) ), q );
+    std::vector< Matrix4<Scalar> > model( count, view.OrthoInverse() ), modelView( count );
+    std::vector<Scalar> modelViewData( 16 * count );
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            Matrix4Kernel<Scalar, false>::Multiply( view.GetData(), model[i].GetData(), &modelViewData[ 16 * i ] );
+        }
+        Benchmark::ClobberMemory();
+    }
+    portableNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+
+    timer.Start();
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            modelView[i] = view * model[i];
+        }
+        Benchmark::ClobberMemory();
+    }
+    simdNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+    Benchmark::DoNotOptimize( modelView[ count / 2 ] );
+    Benchmark::DoNotOptimize( modelViewData[ 8 * count ] );
+}
+
+// Polyline transform (route, track trail): Matrix4 * Vector3 per point
+// against TransformPoints.
+template <typename Scalar>
+static void RunTransformPoints( size_t count, unsigned frames, double& perPointNs, double& batchNs )
+{
+    typedef Vector3<Scalar> Vec;
+    std::vector<Vec> local( count ), global( count );
+    for( size_t i = 0; i < count; ++i ) {
+        local[i] = Vec( Scalar( i % 11 ), Scalar( 0.0 ), Scalar( i % 13 ) );
+    }
+
+    Quaternion<Scalar> q;
+    q.FromAxisAngle( Vec( Scalar( 0.0 ), Scalar( -1.0 ), Scalar( 0.0 ) ), Scalar( 0.3 ) );
+    Matrix4<Scalar> tm;
+    tm.CalculateTransformMatrix( Vector4<Scalar>( Scalar( 10.0 ), Scalar( 0.0 ), Scalar( -3.0 ), Scalar( 1.0 ) ), q );
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            global[i] = tm * local[i];
+        }
+        Benchmark::ClobberMemory();
+    }
+    perPointNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+
+    timer.Start();
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        tm.TransformPoints( &local[0], &global[0], count );
+        Benchmark::ClobberMemory();
+    }
+    batchNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+    Benchmark::DoNotOptimize( global[ count / 2 ] );
+}
+
+// Fleet of aircraft poses applied to the 18 vertex render model: quaternion
+// and translation per vertex (RotateFast + t) against the poses stored as
+// dual quaternions and applied with the batched TransformMany.
+template <typename Scalar>
+static void RunPoses( size_t numPoses, unsigned frames, double& perVertexNs, double& batchNs )
+{
+    typedef Vector3<Scalar> Vec;
+    const size_t numVertices = 18;
+    std::vector<Vec> model( numVertices ), out( numPoses * numVertices );
+    for( size_t i = 0; i < numVertices; ++i ) {
+        model[i] = Vec( Scalar( i % 7 ), Scalar( 0.0 ), Scalar( i % 5 ) );
+    }
+
+    std::vector< Quaternion<Scalar> > rotations( numPoses );
+    std::vector< Vec > positions( numPoses );
+    std::vector< DualQuaternion<Scalar> > poses( numPoses );
+    for( size_t p = 0; p < numPoses; ++p )
+    {
+        rotations[p].FromAxisAngle( Vec( Scalar( 0.0 ), Scalar( -1.0 ), Scalar( 0.0 ) ), Scalar( 0.01 * p ) );
+        positions[p] = Vec( Scalar( p ), Scalar( 0.0 ), Scalar( -0.5 * p ) );
+        poses[p].FromRotationTranslation( rotations[p], positions[p] );
+    }
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        for( size_t p = 0; p < numPoses; ++p )
+        {
+            for( size_t i = 0; i < numVertices; ++i )
+            {
+                out[ p * numVertices + i ] = rotations[p].RotateFast( model[i] ) + positions[p];
+            }
+        }
+        Benchmark::ClobberMemory();
+    }
+    perVertexNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * numPoses * numVertices );
+
+    timer.Start();
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        TransformMany( &poses[0], numPoses, &model[0], numVertices, &out[0] );
+        Benchmark::ClobberMemory();
+    }
+    batchNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * numPoses * numVertices );
+    Benchmark::DoNotOptimize( out[ numVertices ] );
+}
+
+// Render-rate attitude of a fleet between two physics steps, a few degrees apart.
+template <typename Scalar>
+static void RunInterpolate( size_t count, unsigned frames, double& slerpNs, double& nlerpNs )
+{
+    std::mt19937 rng( 17 );
+    std::uniform_real_distribution<float> angle( 0.0f, 6.28f );
+    std::uniform_real_distribution<float> step( -0.05f, 0.05f );
+    const Vector3<Scalar> up( Scalar( 0.0 ), Scalar( 1.0 ), Scalar( 0.0 ) );
+
+    std::vector< Quaternion<Scalar> > prev( count );
+    std::vector< Quaternion<Scalar> > next( count );
+    std::vector< Quaternion<Scalar> > out( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        const float hdg = angle( rng );
+        prev[i].FromAxisAngle( up, hdg );
+        next[i].FromAxisAngle( up, hdg + step( rng ) );
+    }
+
+    Benchmark::Timer timer;
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        SlerpMany( &prev[0], &next[0], &out[0], count, static_cast<Scalar>( f % 16 ) / Scalar( 16.0 ) );
+        Benchmark::ClobberMemory();
+    }
+    slerpNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+    Benchmark::DoNotOptimize( out[ count / 2 ] );
+
+    timer.Start();
+    for( unsigned f = 0; f < frames; ++f )
+    {
+        NlerpMany( &prev[0], &next[0], &out[0], count, static_cast<Scalar>( f % 16 ) / Scalar( 16.0 ) );
+        Benchmark::ClobberMemory();
+    }
+    nlerpNs = timer.ElapsedNs() / ( static_cast<double>( frames ) * count );
+    Benchmark::DoNotOptimize( out[ count / 2 ] );
+}
+
+// Trigonometry of the navigation code, argument x (and y for Atan2) per call.
+struct SinOp
+{
+    static const char* Name() { return "sin"; }
+    static double Lo() { return -2.0 * PI; }
+    static double Hi() { return  2.0 * PI; }
+    template <typename T, typename S> static S Eval( S x, S )         { return T::Sin( x ); }
+#if GRAPHENE_SIMD
+    template <typename T>             static __m128 Lanes( __m128 x, __m128 ) { return T::Sin( x ); }
+#endif
+    static double Reference( double x, double )                      { return sin( x ); }
+};
+
+struct AtanOp
+{
+    static const char* Name() { return "atan"; }
+    static double Lo() { return -20.0; }
+    static double Hi() { return  20.0; }
+    template <typename T, typename S> static S Eval( S x, S )         { return T::Atan( x ); }
+#if GRAPHENE_SIMD
+    template <typename T>             static __m128 Lanes( __m128 x, __m128 ) { return T::Atan( x ); }
+#endif
+    static double Reference( double x, double )                      { return atan( x ); }
+};
+
+struct Atan2Op
+{
+    static const char* Name() { return "atan2"; }
+    static double Lo() { return -100.0; }
+    static double Hi() { return  100.0; }
+    template <typename T, typename S> static S Eval( S x, S y )       { return T::Atan2( y, x ); }
+#if GRAPHENE_SIMD
+    template <typename T>             static __m128 Lanes( __m128 x, __m128 y ) { return T::Atan2( y, x ); }
+#endif
+    static double Reference( double x, double y )                    { return atan2( y, x ); }
+};
+
+struct AsinOp
+{
+    static const char* Name() { return "asin"; }
+    static double Lo() { return -1.0; }
+    static double Hi() { return  1.0; }
+    template <typename T, typename S> static S Eval( S x, S )         { return T::Asin( x ); }
+#if GRAPHENE_SIMD
+    template <typename T>             static __m128 Lanes( __m128 x, __m128 ) { return T::Asin( x ); }
+#endif
+    static double Reference( double x, double )                      { return asin( x ); }
+};
+
+template <typename Op, typename Scalar>
+struct TrigArgs
+{
+    std::vector<Scalar> x;
+    std::vector<Scalar> y;
+    std::vector<Scalar> out;
+
+    explicit TrigArgs( size_t count ) : x( count ), y( count ), out( count )
+    {
+        std::mt19937 rng( 5 );
+        std::uniform_real_distribution<double> arg( Op::Lo(), Op::Hi() );
+        for( size_t i = 0; i < count; ++i ) {
+            x[i] = static_cast<Scalar>( arg( rng ) );
+            y[i] = static_cast<Scalar>( arg( rng ) );
+        }
+    }
+
+    double MaxError() const
+    {
+        double maxError = 0.0;
+        for( size_t i = 0; i < x.size(); ++i ) {
+            const double error = fabs( out[i] - Op::Reference( x[i], y[i] ) );
+            maxError = ( error > maxError ) ? error : maxError;
+        }
+        return maxError;
+    }
+};
+
+// ns per call of Trig<Scalar, Accuracy>, maxError against double libm.
+template <typename Op, typename Scalar, int Accuracy>
+static double RunTrig( TrigArgs<Op, Scalar>& args, unsigned passes, double& maxError )
+{
+    typedef Trig<Scalar, Accuracy> T;
+    const size_t count = args.x.size();
+
+    Benchmark::Timer timer;
+    for( unsigned p = 0; p < passes; ++p )
+    {
+        for( size_t i = 0; i < count; ++i ) {
+            args.out[i] = Op::template Eval<T>( args.x[i], args.y[i] );
+        }
+        Benchmark::ClobberMemory();
+    }
+    const double ns = timer.ElapsedNs() / ( static_cast<double>( passes ) * count );
+    maxError = args.MaxError();
+    return ns;
+}
+
+#if GRAPHENE_SIMD
+// ns per call of TrigLanes<Accuracy>, four floats per call.
+template <typename Op, int Accuracy>
+static double RunTrigLanes( TrigArgs<Op, float>& args, unsigned passes, double& maxError )
+{
+    const size_t count = args.x.size();
+
+    Benchmark::Timer timer;
+    for( unsigned p = 0; p < passes; ++p )
+    {
+        for( size_t i = 0; i + 4 <= count; i += 4 ) {
+            _mm_storeu_ps( &args.out[i], Op::template Lanes< TrigLanes<Accuracy> >( _mm_loadu_ps( &args.x[i] ),
+                                                                                    _mm_loadu_ps( &args.y[i] ) ) );
+        }
+        Benchmark::ClobberMemory();
+    }
+    const double ns = timer.ElapsedNs() / ( static_cast<double>( passes ) * count );
+    maxError = args.MaxError();
+    return ns;
+}
+#endif
+
+template <typename Op, typename Scalar>
+static void PrintTrig( const char* type, size_t count, unsigned passes )
+{
+    TrigArgs<Op, Scalar> args( count );
+    double error1e4 = 0.0;
+    double error1e6 = 0.0;
+    double errorLibm = 0.0;
+    const double libmNs = RunTrig<Op, Scalar, eTrigLibm>( args, passes, errorLibm );
+    const double ns1e4  = RunTrig<Op, Scalar, eTrig1e4>( args, passes, error1e4 );
+    const double ns1e6  = RunTrig<Op, Scalar, eTrig1e6>( args, passes, error1e6 );
+
+    char name[64];
+    snprintf( name, sizeof( name ), "%s %s", Op::Name(), type );
+    printf( "%-16s %8.2f %8.2f %8.2f %10.1e %10.1e\n", name, libmNs, ns1e4, ns1e6, error1e4, error1e6 );
+}
+
+#if GRAPHENE_SIMD
+template <typename Op>
+static void PrintTrigLanes( size_t count, unsigned passes )
+{
+    TrigArgs<Op, float> args( count );
+    double error1e4 = 0.0;
+    double error1e6 = 0.0;
+    double errorLibm = 0.0;
+    const double libmNs = RunTrig<Op, float, eTrigLibm>( args, passes, errorLibm );
+    const double ns1e4  = RunTrigLanes<Op, eTrig1e4>( args, passes, error1e4 );
+    const double ns1e6  = RunTrigLanes<Op, eTrig1e6>( args, passes, error1e6 );
+
+    char name[64];
+    snprintf( name, sizeof( name ), "%s float x4", Op::Name() );
+    printf( "%-16s %8.2f %8.2f %8.2f %10.1e %10.1e\n", name, libmNs, ns1e4, ns1e6, error1e4, error1e6 );
+}
+#endif
+
+static void Print( const char* name, double scalarNs, double simdNs )
+{
+    printf( "%-36s %12.2f %12.2f %9.2fx\n", name, scalarNs, simdNs, scalarNs / simdNs );
+}
+
+int main()
+{
+    const size_t   count  = 4096;
+    const unsigned frames = 2000;
+
+    printf( "GrapheneMath, %u aircraft x %u frames, GRAPHENE_SIMD %d\n",
+            static_cast<unsigned>( count ), frames, GRAPHENE_SIMD );
+    printf( "%-36s %12s %12s %10s\n", "loop (ns per aircraft)", "portable", "SIMD", "speedup" );
+
+    Print( "fleet update Vector3<float>",
+           RunFleet< Vector3<float, false> >( count, frames ),
+           RunFleet< Vector3<float> >( count, frames ) );
+    Print( "fleet update Vector3<double>",
+           RunFleet< Vector3<double, false> >( count, frames ),
+           RunFleet< Vector3<double> >( count, frames ) );
+    Print( "blend Vector4<float>",
+           RunVector4< Vector4<float, false> >( count, frames ),
+           RunVector4< Vector4<float> >( count, frames ) );
+    Print( "blend Vector4<double>",
+           RunVector4< Vector4<double, false> >( count, frames ),
+           RunVector4< Vector4<double> >( count, frames ) );
+
+    double perVertexNs = 0.0;
+    double manyNs      = 0.0;
+    printf( "\n%-36s %12s %12s %10s\n", "vertices (ns per vertex)", "RotateFast x2", "RotateMany", "speedup" );
+    RunRotate<float>( count, frames, perVertexNs, manyNs );
+    Print( "render model Vector3<float>", perVertexNs, manyNs );
+    RunRotate<double>( count, frames, perVertexNs, manyNs );
+    Print( "render model Vector3<double>", perVertexNs, manyNs );
+
+    double perOpNs = 0.0;
+    double fusedNs = 0.0;
+    printf( "\n%-36s %12s %12s %10s\n", "array expressions (ns per element)", "per operator", "Expr fused", "speedup" );
+    RunArrayExpr< Vector3<float> >( count, frames, perOpNs, fusedNs );
+    Print( "Vector3<float>", perOpNs, fusedNs );
+    RunArrayExpr< Vector3<double> >( count, frames, perOpNs, fusedNs );
+    Print( "Vector3<double>", perOpNs, fusedNs );
+    RunArrayExpr< Vector4<float> >( count, frames, perOpNs, fusedNs );
+    Print( "Vector4<float>", perOpNs, fusedNs );
+
+    double portableNs = 0.0;
+    double simdNs     = 0.0;
+    printf( "\n%-36s %12s %12s %10s\n", "view * model (ns per product)", "portable", "SIMD", "speedup" );
+    RunMatrixMultiply<float>( 256, frames * 4, portableNs, simdNs );
+    Print( "multiply Matrix4<float>", portableNs, simdNs );
+    RunMatrixMultiply<double>( 256, frames * 4, portableNs, simdNs );
+    Print( "multiply Matrix4<double>", portableNs, simdNs );
+
+    const size_t   numPoints  = 1 << 18;
+    const unsigned passes     = 100;
+    double perPointNs = 0.0;
+    double batchNs    = 0.0;
+    printf( "\n%-36s %12s %12s %10s\n", "polyline, 256K points (ns per point)", "operator*", "Transform", "speedup" );
+    RunTransformPoints<float>( numPoints, passes, perPointNs, batchNs );
+    Print( "TransformPoints Vector3<float>", perPointNs, batchNs );
+    RunTransformPoints<double>( numPoints, passes, perPointNs, batchNs );
+    Print( "TransformPoints Vector3<double>", perPointNs, batchNs );
+
+    printf( "\n%-36s %12s %12s %10s\n", "fleet poses (ns per vertex)", "quat + t", "DualQuat", "speedup" );
+    RunPoses<float>( 1024, frames / 4, perVertexNs, manyNs );
+    Print( "1024 poses x 18 vertices float", perVertexNs, manyNs );
+    RunPoses<double>( 1024, frames / 4, perVertexNs, manyNs );
+    Print( "1024 poses x 18 vertices double", perVertexNs, manyNs );
+
+    double slerpNs = 0.0;
+    double nlerpNs = 0.0;
+    printf( "\n%-36s %12s %12s %10s\n", "attitude (ns per aircraft)", "SlerpMany", "NlerpMany", "speedup" );
+    RunInterpolate<float>( count, frames, slerpNs, nlerpNs );
+    Print( "interpolate Quaternion<float>", slerpNs, nlerpNs );
+    RunInterpolate<double>( count, frames, slerpNs, nlerpNs );
+    Print( "interpolate Quaternion<double>", slerpNs, nlerpNs );
+
+    printf( "\n%-16s %8s %8s %8s %10s %10s\n", "trig (ns/call)", "libm", "1e-4", "1e-6", "error 1e-4", "error 1e-6" );
+    PrintTrig<SinOp, float>( "float", count, frames / 4 );
+    PrintTrig<SinOp, double>( "double", count, frames / 4 );
+    PrintTrig<AtanOp, float>( "float", count, frames / 4 );
+    PrintTrig<AtanOp, double>( "double", count, frames / 4 );
+    PrintTrig<Atan2Op, float>( "float", count, frames / 4 );
+    PrintTrig<Atan2Op, double>( "double", count, frames / 4 );
+    PrintTrig<AsinOp, float>( "float", count, frames / 4 );
+    PrintTrig<AsinOp, double>( "double", count, frames / 4 );
+#if GRAPHENE_SIMD
+    PrintTrigLanes<SinOp>( count, frames / 4 );
+    PrintTrigLanes<AtanOp>( count, frames / 4 );
+    PrintTrigLanes<Atan2Op>( count, frames / 4 );
+    PrintTrigLanes<AsinOp>( count, frames / 4 );
+#endif
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+// GrapheneMath: cost of the single operations the rest of the code is built
+// from, with warm-up, median and p99 over repetitions (Benchmark::Runner).
+// Build and run with 'make kernelbench', which also writes mathKernels.json:
+//
+//   ./NavexKernelBench [results.json]
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmark.h"
+#include "vector3.h"
+#include "quat.h"
+#include "matrix3.h"
+#include "matrix4.h"
+
+using namespace GrapheneMath;
+
+// Operations per timed repetition: small enough to stay in L1, large enough
+// for the timer resolution.
+static const size_t c_batch = 1024;
+
+// Random unit quaternions, vectors and rigid transforms to operate on.
+template <typename Scalar>
+struct KernelInputs
+{
+    std::vector< Vector3<Scalar> >    vecA;
+    std::vector< Vector3<Scalar> >    vecB;
+    std::vector< Quaternion<Scalar> > quatA;
+    std::vector< Quaternion<Scalar> > quatB;
+    std::vector< Matrix3<Scalar> >    mat3;
+    std::vector< Matrix4<Scalar> >    mat4;
+
+    KernelInputs()
+        : vecA( c_batch ), vecB( c_batch ), quatA( c_batch ), quatB( c_batch ), mat3( c_batch ), mat4( c_batch )
+    {
+        std::mt19937 rng( 3 );
+        std::uniform_real_distribution<double> unit( -1.0, 1.0 );
+        std::uniform_real_distribution<double> angle( 0.0, 6.28 );
+
+        for( size_t i = 0; i < c_batch; ++i )
+        {
+            vecA[i] = Vector3<Scalar>( unit( rng ), unit( rng ), unit( rng ) );
+            vecB[i] = Vector3<Scalar>( unit( rng ), unit( rng ), unit( rng ) );
+
+            Vector3<Scalar> axis = vecA[i];
+            axis.Normalise();
+            quatA[i].FromAxisAngle( axis, static_cast<Scalar>( angle( rng ) ) );
+            axis = vecB[i];
+            axis.Normalise();
+            quatB[i].FromAxisAngle( axis, static_cast<Scalar>( angle( rng ) ) );
+
+            mat3[i].FromQuat( quatA[i] );
+            mat4[i].CalculateTransformMatrix( Vector4<Scalar>( vecB[i].GetX(), vecB[i].GetY(), vecB[i].GetZ(), Scalar( 0.0 ) ),
+                                              quatA[i] );
+        }
+    }
+};
+
+template <typename Scalar>
+static void RunKernels( Benchmark::Runner& runner, const char* type )
+{
+    const KernelInputs<Scalar> in;
+    std::vector< Vector3<Scalar> >    vecOut( c_batch );
+    std::vector< Quaternion<Scalar> > quatOut( c_batch );
+    std::vector< Matrix3<Scalar> >    mat3Out( c_batch );
+    std::vector< Matrix4<Scalar> >    mat4Out( c_batch );
+    char name[64];
+
+    snprintf( name, sizeof( name ), "Vector3<%s> a + b", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { vecOut[i] = in.vecA[i] + in.vecB[i]; }
+        Benchmark::DoNotOptimize( vecOut[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Vector3<%s> Cross", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { vecOut[i] = in.vecA[i].Cross( in.vecB[i] ); }
+        Benchmark::DoNotOptimize( vecOut[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Vector3<%s> Normalise", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { vecOut[i] = in.vecA[i]; vecOut[i].Normalise(); }
+        Benchmark::DoNotOptimize( vecOut[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Quaternion<%s> operator*", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { quatOut[i] = in.quatA[i] * in.quatB[i]; }
+        Benchmark::DoNotOptimize( quatOut[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Quaternion<%s> operator^", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { quatOut[i] = in.quatA[i] ^ in.quatB[i]; }
+        Benchmark::DoNotOptimize( quatOut[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Quaternion<%s> RotateFast", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { vecOut[i] = in.quatA[i].RotateFast( in.vecB[i] ); }
+        Benchmark::DoNotOptimize( vecOut[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Matrix3<%s> FromQuat", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { mat3Out[i].FromQuat( in.quatA[i] ); }
+        Benchmark::DoNotOptimize( mat3Out[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Matrix3<%s> SetInverse", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { mat3Out[i].SetInverse( in.mat3[i] ); }
+        Benchmark::DoNotOptimize( mat3Out[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Matrix4<%s> OrthoInverse", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { mat4Out[i] = in.mat4[i].OrthoInverse(); }
+        Benchmark::DoNotOptimize( mat4Out[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Matrix4<%s> SetInverse", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { mat4Out[i].SetInverse( in.mat4[i] ); }
+        Benchmark::DoNotOptimize( mat4Out[0] );
+    } );
+
+    snprintf( name, sizeof( name ), "Matrix4<%s> operator*", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i ) { mat4Out[i] = in.mat4[i] * in.mat4[ c_batch - 1 - i ]; }
+        Benchmark::DoNotOptimize( mat4Out[0] );
+    } );
+
+    // The portable kernel operator* replaces when SIMD is enabled.
+    std::vector<Scalar> mat4Raw( 16 * c_batch );
+    snprintf( name, sizeof( name ), "Matrix4<%s> operator* portable", type );
+    runner.Run( name, c_batch, [&]() {
+        for( size_t i = 0; i < c_batch; ++i )
+        {
+            Scalar out[16]; //< local as in operator*, a store to mat4Raw may alias the inputs
+            Matrix4Kernel<Scalar, false>::Multiply( in.mat4[i].GetData(), in.mat4[ c_batch - 1 - i ].GetData(), out );
+            std::copy( out, out + 16, &mat4Raw[ 16 * i ] );
+        }
+        Benchmark::DoNotOptimize( mat4Raw[0] );
+    } );
+}
+
+int main( int argc, char* argv[] )
+{
+    Benchmark::Runner runner;
+
+    RunKernels<float>( runner, "float" );
+    RunKernels<double>( runner, "double" );
+
+    printf( "GrapheneMath kernels, GRAPHENE_SIMD %d, GRAPHENE_PRECISION %d, %u ops x 200 reps\n",
+            GRAPHENE_SIMD, GRAPHENE_PRECISION, static_cast<unsigned>( c_batch ) );
+    runner.PrintTable( stdout );
+
+    if( argc > 1 )
+    {
+        FILE* json = fopen( argv[1], "w" );
+        if( !json )
+        {
+            fprintf( stderr, "Can't open %s\n", argv[1] );
+            return 1;
+        }
+        runner.PrintJson( json, "GrapheneMath" );
+        fclose( json );
+        printf( "JSON written to %s\n", argv[1] );
+    }
+
+    return 0;
+}
@@ -9,9 +9,22 @@
 
 namespace GrapheneMath
 {
-    // Define the real number precision. GrapheneMath can be compiled in single or
-    // double precision versions. By default single precision is provided.
+    // Define the real number precision. GrapheneMath can be compiled in single,
+    // double or extended precision versions, selected with GRAPHENE_PRECISION
+    // (1 float, 2 double, 3 long double). By default extended precision is provided.
+#ifndef GRAPHENE_PRECISION
+#define GRAPHENE_PRECISION 3
+#endif
+
+#if GRAPHENE_PRECISION == 1
+    typedef float Real;
+#elif GRAPHENE_PRECISION == 2
+    typedef double Real;
+#elif GRAPHENE_PRECISION == 3
     typedef long double Real;
+#else
+#error "GRAPHENE_PRECISION must be 1 (float), 2 (double) or 3 (long double)"
+#endif
 
     template<typename Scalar>
     class Matrix4;
@@ -22,25 +35,69 @@ namespace GrapheneMath
     template<typename Scalar>
     class DualQuaternion;
 
-    static const Real PI = Real(3.14159265358979323846264338327950288419716939937510582097494459230781640628620899862);
-    static const Real PI_OVER_TWO = Real(1.57079632679489661923132169163975144209858469968755291048747229615390820314310449931);
-    static const Real NUM_TOLERANCE = Real(1E-4);
-    static const Real ONE = Real(1.0);
-    static const Real TWO = Real(2.0);
-    static const Real ONE_EIGHTY = Real(180.0);
-    static const Real PI_OVER_ONE_EIGHTY = PI / ONE_EIGHTY;
-    static const Real ONE_EIGHTY_OVER_PI = ONE_EIGHTY / PI;
+    // Long double literals independent of GRAPHENE_PRECISION, every precision
+    // rounds from these once (Real below, Constants<Scalar>, the solver's DEG_TO_RAD).
+    static constexpr long double PI_L = 3.14159265358979323846264338327950288419716939937510582097494459230781640628620899862L;
+    static constexpr long double PI_OVER_TWO_L = 1.57079632679489661923132169163975144209858469968755291048747229615390820314310449931L;
+    static constexpr long double PI_OVER_ONE_EIGHTY_L = PI_L / 180.0L;
+    static constexpr long double ONE_EIGHTY_OVER_PI_L = 180.0L / PI_L;
+
+    static constexpr Real PI = Real(PI_L);
+    static constexpr Real PI_OVER_TWO = Real(PI_OVER_TWO_L);
+    static constexpr Real NUM_TOLERANCE = Real(1E-4);
+    static constexpr Real ONE = Real(1.0);
+    static constexpr Real TWO = Real(2.0);
+    static constexpr Real ONE_EIGHTY = Real(180.0);
+    static constexpr Real PI_OVER_ONE_EIGHTY = Real(PI_OVER_ONE_EIGHTY_L);
+    static constexpr Real ONE_EIGHTY_OVER_PI = Real(ONE_EIGHTY_OVER_PI_L);
+
+    // The long double constants rounded once, at compile time, to the precision of Scalar,
+    // so float Real does not cost the double and long double kernels accuracy.
+    // Mixing a Real constant into float or double math promotes the whole
+    // expression to Real (x87 80 bit arithmetic for long double), use these instead.
+    template<typename Scalar>
+    struct Constants
+    {
+        static constexpr Scalar Pi()           { return static_cast<Scalar>( PI_L ); }
+        static constexpr Scalar PiOverTwo()    { return static_cast<Scalar>( PI_OVER_TWO_L ); }
+        static constexpr Scalar NumTolerance() { return static_cast<Scalar>( NUM_TOLERANCE ); }
+        static constexpr Scalar DegToRad()     { return static_cast<Scalar>( PI_OVER_ONE_EIGHTY_L ); }
+        static constexpr Scalar RadToDeg()     { return static_cast<Scalar>( ONE_EIGHTY_OVER_PI_L ); }
+    };
+
+    template<typename Scalar>
+    constexpr Scalar Deg2Rad( Scalar angleDeg )
+    {
+        return ( angleDeg * Constants<Scalar>::DegToRad() );
+    }
+
+    template<typename Scalar>
+    constexpr Scalar Rad2Deg( Scalar angleRad )
+    {
+        return ( angleRad * Constants<Scalar>::RadToDeg() );
+    }
+
+    // Taylor series term by term: term(n + 2) = -term(n) * x^2 / ((n + 1)(n + 2)).
+    template<typename Scalar>
+    constexpr Scalar TaylorSeries( Scalar xSquared, Scalar term, unsigned n )
+    {
+        return ( n > 30u ) ? term
+                           : term + TaylorSeries( xSquared, -term * xSquared / Scalar( ( n + 1u ) * ( n + 2u ) ), n + 2u );
+    }
 
+    // Compile-time sine and cosine for fixed angles (radians, |angle| <= PI),
+    // e.g. the half angles of constant quaternion rotations.
+    // At run time use sin() and cos().
     template<typename Scalar>
-    const Scalar Deg2Rad( Scalar angleDeg )
+    constexpr Scalar ConstSin( Scalar angle )
     {
-        return ( angleDeg * PI_OVER_ONE_EIGHTY );
+        return TaylorSeries( angle * angle, angle, 1u );
     }
 
     template<typename Scalar>
-    const Scalar Rad2Deg( Scalar angleRad )
+    constexpr Scalar ConstCos( Scalar angle )
     {
-        return ( angleRad * ONE_EIGHTY_OVER_PI );
+        return TaylorSeries( angle * angle, Scalar( 1.0 ), 0u );
     }
 
     template<typename Scalar>
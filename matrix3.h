@@ -17,7 +17,7 @@ namespace GrapheneMath
         Scalar m_data[ 9 ];
 
     public:
-        Matrix3(
+        constexpr Matrix3(
             const Scalar& r0 = Scalar{},
             const Scalar& r1 = Scalar{},
             const Scalar& r2 = Scalar{},
@@ -27,23 +27,35 @@ namespace GrapheneMath
             const Scalar& r6 = Scalar{},
             const Scalar& r7 = Scalar{},
             const Scalar& r8 = Scalar{} )
-        {
-            m_data[0] = r0; m_data[1] = r1; m_data[2] = r2;
-            m_data[3] = r3; m_data[4] = r4; m_data[5] = r5;
-            m_data[6] = r6; m_data[7] = r7; m_data[8] = r8;
-        }
+            : m_data{ r0, r1, r2,
+                      r3, r4, r5,
+                      r6, r7, r8 }
+        {}
 
-        Matrix3(
+        constexpr Matrix3(
             const Vector3<Scalar>& row0,
             const Vector3<Scalar>& row1,
             const Vector3<Scalar>& row2 )
-        {
-            m_data[0] = row0.GetX(); m_data[1] = row0.GetY(); m_data[2] = row0.GetZ();
-            m_data[3] = row1.GetX(); m_data[4] = row1.GetY(); m_data[5] = row1.GetZ();
-            m_data[6] = row2.GetX(); m_data[7] = row2.GetY(); m_data[8] = row2.GetZ();
-        }
-
-        const Matrix3<Scalar> Transpose() const
+            : m_data{ row0.GetX(), row0.GetY(), row0.GetZ(),
+                      row1.GetX(), row1.GetY(), row1.GetZ(),
+                      row2.GetX(), row2.GetY(), row2.GetZ() }
+        {}
+
+        // Rotation matrix of unit quaternion q, constexpr so that fixed
+        // rotations can be tabulated at compile time.
+        explicit constexpr Matrix3( const Quaternion<Scalar>& q )
+            : m_data{ Scalar( ONE ) - Scalar( TWO ) * ( q.GetY() * q.GetY() + q.GetZ() * q.GetZ() ),
+                      Scalar( TWO ) * ( q.GetX() * q.GetY() + q.GetZ() * q.GetW() ),
+                      Scalar( TWO ) * ( q.GetX() * q.GetZ() - q.GetY() * q.GetW() ),
+                      Scalar( TWO ) * ( q.GetX() * q.GetY() - q.GetZ() * q.GetW() ),
+                      Scalar( ONE ) - Scalar( TWO ) * ( q.GetX() * q.GetX() + q.GetZ() * q.GetZ() ),
+                      Scalar( TWO ) * ( q.GetY() * q.GetZ() + q.GetX() * q.GetW() ),
+                      Scalar( TWO ) * ( q.GetX() * q.GetZ() + q.GetY() * q.GetW() ),
+                      Scalar( TWO ) * ( q.GetY() * q.GetZ() - q.GetX() * q.GetW() ),
+                      Scalar( ONE ) - Scalar( TWO ) * ( q.GetX() * q.GetX() + q.GetY() * q.GetY() ) }
+        {}
+
+        constexpr const Matrix3<Scalar> Transpose() const
         {
             return Matrix3(m_data[0], m_data[3], m_data[6],
                            m_data[1], m_data[4], m_data[7],
@@ -59,8 +71,8 @@ namespace GrapheneMath
             return *this;
         }
 
-        const Vector3<Scalar> operator*( const Vector3<Scalar>& vec ) const;
-        const Matrix3<Scalar> operator*( Scalar s ) const;
+        constexpr const Vector3<Scalar> operator*( const Vector3<Scalar>& vec ) const;
+        constexpr const Matrix3<Scalar> operator*( Scalar s ) const;
         const Matrix3<Scalar> operator*( const Matrix3<Scalar>& mat) const;
 
         const Scalar operator[](int index) const
@@ -70,14 +82,11 @@ namespace GrapheneMath
             return m_data[idx];
         }
 
-        const Scalar GetDeterminant() const
+        constexpr const Scalar GetDeterminant() const
         {
-            const Scalar det =
-                ((m_data[0] * (m_data[4] * m_data[8] - m_data[5] * m_data[7])) -
-                ( m_data[1] * (m_data[3] * m_data[8] - m_data[5] * m_data[6])) +
-                ( m_data[2] * (m_data[3] * m_data[7] - m_data[4] * m_data[6])));
-
-            return det;
+            return ((m_data[0] * (m_data[4] * m_data[8] - m_data[5] * m_data[7])) -
+                    ( m_data[1] * (m_data[3] * m_data[8] - m_data[5] * m_data[6])) +
+                    ( m_data[2] * (m_data[3] * m_data[7] - m_data[4] * m_data[6])));
         }
 
         const Matrix3<Scalar> operator-(const Matrix3<Scalar>& mat) const;
@@ -95,22 +104,12 @@ namespace GrapheneMath
 
         void FromQuat(const Quaternion<Scalar>& q)
         {
-            const Scalar ONE = Scalar(1.0);
-            const Scalar TWO = Scalar(2.0);
-            m_data[0] = ONE - (TWO * q.GetY() * q.GetY() + TWO * q.GetZ() * q.GetZ());
-            m_data[1] = TWO * q.GetX() * q.GetY() + TWO * q.GetZ() * q.GetW();
-            m_data[2] = TWO * q.GetX() * q.GetZ() - TWO * q.GetY() * q.GetW();
-            m_data[3] = TWO * q.GetX() * q.GetY() - TWO * q.GetZ() * q.GetW();
-            m_data[4] = ONE - (TWO * q.GetX() * q.GetX() + TWO * q.GetZ() * q.GetZ());
-            m_data[5] = TWO * q.GetY() * q.GetZ() + TWO * q.GetX() * q.GetW();
-            m_data[6] = TWO * q.GetX() * q.GetZ() + TWO * q.GetY() * q.GetW();
-            m_data[7] = TWO * q.GetY() * q.GetZ() - TWO * q.GetX() * q.GetW();
-            m_data[8] = ONE - (TWO * q.GetX() * q.GetX() + TWO * q.GetY() * q.GetY());
+            *this = Matrix3( q );
         }
     };
     
     template <typename Scalar>
-        const Vector3<Scalar> Matrix3<Scalar>::operator*(const Vector3<Scalar>& vec) const
+        constexpr const Vector3<Scalar> Matrix3<Scalar>::operator*(const Vector3<Scalar>& vec) const
         {
             return Vector3<Scalar>(
                 vec.GetX() * m_data[0] +
@@ -127,7 +126,7 @@ namespace GrapheneMath
         }
 
         template <typename Scalar>
-        const Matrix3<Scalar> Matrix3<Scalar>::operator*(Scalar s) const
+        constexpr const Matrix3<Scalar> Matrix3<Scalar>::operator*(Scalar s) const
         {
             return Matrix3<Scalar>(
                 m_data[0] * s,
@@ -242,7 +241,7 @@ namespace GrapheneMath
                  t10 * mat.m_data[7] + t12 * mat.m_data[5] - t14 * mat.m_data[4]);
 
             // make sure the determinant is non-zero
-            if (abs(t16) < 1.0E-10) return; // TODO add global tolerance
+            if (fabs(t16) < Scalar(1.0E-10)) return; // TODO add global tolerance
 
             const Scalar t17 = Scalar(1.0) / t16;
 
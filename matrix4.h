@@ -1,11 +1,49 @@
 #ifndef __MATRIX4_H__
 #define __MATRIX4_H__
 
+#include <cstddef>
 #include "vector4.h"
 #include "matrix3.h"
 
 namespace GrapheneMath
 {
+    // 4x4 row-major product out = a * b on raw arrays, out must not alias a or b.
+    // For double with SIMD enabled the specialisation below is used,
+    // Matrix4Kernel<Scalar, false> always selects this portable version.
+    template <typename Scalar, bool Simd = SimdTraits<Scalar>::enabled>
+    struct Matrix4Kernel
+    {
+        static inline void Multiply( const Scalar* a, const Scalar* b, Scalar* out )
+        {
+            for( int row = 0; row < 16; row += 4 )
+            {
+                for( int col = 0; col < 4; ++col )
+                {
+                    out[row + col] = a[row]     * b[col]     +
+                                     a[row + 1] * b[4 + col] +
+                                     a[row + 2] * b[8 + col] +
+                                     a[row + 3] * b[12 + col];
+                }
+            }
+        }
+    };
+
+    template <typename Scalar>
+    struct Matrix4Kernel<Scalar, true>
+    {
+        static inline void Multiply( const Scalar* a, const Scalar* b, Scalar* out )
+        {
+            SimdTraits<Scalar>::MatMul4( a, b, out );
+        }
+    };
+
+    // The compiler already keeps the portable float product in SSE registers,
+    // broadcasting a[i] lane by lane measured no faster (12 ns either way).
+    template <>
+    struct Matrix4Kernel<float, true> : Matrix4Kernel<float, false>
+    {
+    };
+
     /**
      * Holds a transform matrix, consisting of rotation matrix and a position.
      * homogenous matrix, p 154 Robotics book
@@ -25,7 +63,18 @@ namespace GrapheneMath
         };
 
     private:
-        Scalar m_data[ numOfElems ];
+        alignas(16) Scalar m_data[ numOfElems ]; //< rows 16 byte aligned for the SIMD kernels
+
+        // Leaves m_data uninitialised, for results that a kernel writes in full.
+        struct Uninitialised {};
+        explicit Matrix4( Uninitialised ) {}
+
+        // Sets the rotation part from its three columns and the translation,
+        // the bottom row to ( 0 0 0 1 ).
+        void SetFromColumns( const Vector3<Scalar>& col0,
+                             const Vector3<Scalar>& col1,
+                             const Vector3<Scalar>& col2,
+                             const Vector3<Scalar>& translation );
 
     public:
         // Default ctor.
@@ -84,6 +133,22 @@ namespace GrapheneMath
 
         void FromRot3x3Trans( const Matrix3<Scalar>& rotMat, const Vector3<Scalar>& translation );
 
+        // Row-major elements, indexed by Elements.
+        const Scalar* GetData() const { return m_data; }
+
+        // The elements column by column, the layout of glLoadMatrix, glMultMatrix
+        // and GLSL mat4 uniforms.
+        void GetColumnMajor( Scalar out[ numOfElems ] ) const
+        {
+            for( int r = 0; r < 4; ++r )
+            {
+                for( int c = 0; c < 4; ++c )
+                {
+                    out[ c * 4 + r ] = m_data[ r * 4 + c ];
+                }
+            }
+        }
+
         const Scalar operator[](int index) const
         {
             assert(index < numOfElems && index >= 0);
@@ -99,8 +164,12 @@ namespace GrapheneMath
         const Vector4<Scalar> operator*( const Vector4<Scalar>& vec ) const;
         const Vector3<Scalar> operator*( const Vector3<Scalar>& vec ) const;
         
-        //No assumption that both are rotation matrices + homogenous (more concise is possible, this is naive)
+        //No assumption that both are rotation matrices + homogenous, SIMD for double.
         const Matrix4<Scalar> operator*( const Matrix4<Scalar>& mat ) const;
+
+        // Transforms 'count' points with this affine matrix: out[i] = R * in[i] + T.
+        // 'in' and 'out' may be the same array.
+        void TransformPoints( const Vector3<Scalar>* in, Vector3<Scalar>* out, size_t count ) const;
         
         //template <typename Scalar>
         const Matrix3<Scalar> GetRotation3x3() const
@@ -121,14 +190,18 @@ namespace GrapheneMath
         
         void SetTranslation( Scalar x, Scalar y, Scalar z );
 
-        const Matrix4<Scalar> OrthoInverse() const
-        {
-            Matrix4<Scalar> invMat;
-            invMat.SetRotation3x3(GetRotation3x3().Transpose());
-            Vector3<Scalar> translation = (invMat.GetRotation3x3() * Scalar(-1.0)) * GetTranslation();
-            invMat.SetTranslation(translation);
-            return invMat;
-        }
+        // Inverse of a rotation + translation matrix: ( R^T, -R^T * T ).
+        const Matrix4<Scalar> OrthoInverse() const;
+
+        /**
+        * Sets the matrix to be the inverse of the given affine matrix
+        * (any invertible 3x3 part, bottom row ( 0 0 0 1 )).
+        * Left unchanged if the 3x3 part is singular.
+        * @param mat The matrix to invert and use to set this.
+        */
+        void SetInverse( const Matrix4<Scalar>& mat );
+
+        const Matrix4<Scalar> Inverse() const;
 
         // Make transform matrix from position and quaternion.
         const Matrix4<Scalar> CalculateTransformMatrix(const Vector4<Scalar>& position, const Quaternion<Scalar>& orientation);
@@ -175,97 +248,93 @@ namespace GrapheneMath
     template <typename Scalar>
     const Matrix4<Scalar> Matrix4<Scalar>::operator*( const Matrix4<Scalar>& mat ) const
     {
-        const Vector4<Scalar> row0(
-          m_data[ r11 ] * mat[ r11 ] + 
-          m_data[ r12 ] * mat[ r21 ] + 
-          m_data[ r13 ] * mat[ r31 ] + 
-          m_data[ X ]   * mat[ O_ ],
-                           
-          m_data[ r11 ] * mat[ r12 ] + 
-          m_data[ r12 ] * mat[ r22 ] + 
-          m_data[ r13 ] * mat[ r32 ] + 
-          m_data[ X ]   * mat[ _O_ ], 
-                          
-          m_data[ r11 ] * mat[ r13 ] + 
-          m_data[ r12 ] * mat[ r23 ] + 
-          m_data[ r13 ] * mat[ r33 ] + 
-          m_data[ X ]   * mat[ _O ],
-                           
-          m_data[ r11 ] * mat[ X ] + 
-          m_data[ r12 ] * mat[ Y ] + 
-          m_data[ r13 ] * mat[ Z ] + 
-          m_data[ X ]   * mat[ _1_ ] );
-         
-        const Vector4<Scalar> row1(                 
-          m_data[ r21 ] * mat[ r11 ] + 
-          m_data[ r22 ] * mat[ r21 ] + 
-          m_data[ r23 ] * mat[ r31 ] + 
-          m_data[ Y ]   * mat[ O_ ],
-                           
-          m_data[ r21 ] * mat[ r12 ] + 
-          m_data[ r22 ] * mat[ r22 ] + 
-          m_data[ r23 ] * mat[ r32 ] + 
-          m_data[ Y ]   * mat[ _O_ ],
-                           
-          m_data[ r21 ] * mat[ r13 ] + 
-          m_data[ r22 ] * mat[ r23 ] + 
-          m_data[ r23 ] * mat[ r33 ] + 
-          m_data[ Y ]   * mat[ _O ],
-                           
-          m_data[ r21 ] * mat[ X ] + 
-          m_data[ r22 ] * mat[ Y ] + 
-          m_data[ r23 ] * mat[ Z ] + 
-          m_data[ Y ]   * mat[ _1_ ] );
-                   
-        const Vector4<Scalar> row2(                      
-          m_data[ r31 ] * mat[ r11 ] + 
-          m_data[ r32 ] * mat[ r21 ] + 
-          m_data[ r33 ] * mat[ r31 ] + 
-          m_data[ Z ]   * mat[   O_],
-                           
-          m_data[ r31 ] * mat[ r12 ] + 
-          m_data[ r32 ] * mat[ r22 ] + 
-          m_data[ r33 ] * mat[ r32 ] + 
-          m_data[ Z ]   * mat[  _O_],
-                           
-          m_data[ r31 ] * mat[ r13 ] + 
-          m_data[ r32 ] * mat[ r23 ] + 
-          m_data[ r33 ] * mat[ r33 ] + 
-          m_data[ Z ]   * mat[ _O ],
-                           
-          m_data[ r31 ] * mat[ X ] + 
-          m_data[ r32 ] * mat[ Y ] + 
-          m_data[ r33 ] * mat[ Z ] + 
-          m_data[ Z ]   * mat[ _1_ ] );
-                           
-        const Vector4<Scalar> row3(                      
-          m_data[  O_ ] * mat[ r11 ] + 
-          m_data[ _O_ ] * mat[ r21 ] + 
-          m_data[ _O ]  * mat[ r31 ] + 
-          m_data[ _1_ ] * mat[ O_ ],
-                           
-          m_data[  O_ ] * mat[ r12 ] + 
-          m_data[ _O_ ] * mat[ r22 ] + 
-          m_data[ _O ]  * mat[ r32 ] + 
-          m_data[ _1_ ] * mat[ _O_ ],
-                           
-          m_data[  O_ ] * mat[ r13 ] + 
-          m_data[ _O_ ] * mat[ r23 ] + 
-          m_data[ _O ]  * mat[ r33 ] + 
-          m_data[ _1_ ] * mat[ _O ],
-                           
-          m_data[  O_ ] * mat[ X ] + 
-          m_data[ _O_ ] * mat[ Y ] + 
-          m_data[ _O ]  * mat[ Z ] + 
-          m_data[ _1_ ] * mat[ _1_ ] );
-          
-        const Matrix4<Scalar> resultMat( row0,
-                                         row1,
-                                         row2,
-                                         row3 );
-       return resultMat;
+        Matrix4<Scalar> resultMat( ( Uninitialised() ) );
+        Matrix4Kernel<Scalar>::Multiply( m_data, mat.m_data, resultMat.m_data );
+        return resultMat;
+    }
+
+    // The columns of the 3x3 part are loaded once, each point is then three
+    // multiplies and three adds of whole (SIMD) vectors.
+    template <typename Scalar>
+    void Matrix4<Scalar>::TransformPoints( const Vector3<Scalar>* in, Vector3<Scalar>* out, size_t count ) const
+    {
+        const Vector3<Scalar> col0( m_data[r11], m_data[r21], m_data[r31] );
+        const Vector3<Scalar> col1( m_data[r12], m_data[r22], m_data[r32] );
+        const Vector3<Scalar> col2( m_data[r13], m_data[r23], m_data[r33] );
+        const Vector3<Scalar> translation( m_data[X], m_data[Y], m_data[Z] );
+
+        for( size_t i = 0; i < count; ++i )
+        {
+            const Vector3<Scalar>& p = in[i];
+            out[i] = col0.ScalarMult( p.GetX() ) + col1.ScalarMult( p.GetY() ) + col2.ScalarMult( p.GetZ() ) + translation;
+        }
     }
-       
+
+    template <typename Scalar>
+    void Matrix4<Scalar>::SetFromColumns( const Vector3<Scalar>& col0,
+                                          const Vector3<Scalar>& col1,
+                                          const Vector3<Scalar>& col2,
+                                          const Vector3<Scalar>& translation )
+    {
+        m_data[r11] = col0.GetX(); m_data[r12] = col1.GetX(); m_data[r13] = col2.GetX(); m_data[X] = translation.GetX();
+        m_data[r21] = col0.GetY(); m_data[r22] = col1.GetY(); m_data[r23] = col2.GetY(); m_data[Y] = translation.GetY();
+        m_data[r31] = col0.GetZ(); m_data[r32] = col1.GetZ(); m_data[r33] = col2.GetZ(); m_data[Z] = translation.GetZ();
+        m_data[ O_] = 0;
+        m_data[_O_] = 0;
+        m_data[_O ] = 0;
+        m_data[_1_] = 1;
+    }
+
+    // The columns of R^T are the rows of R.
+    template <typename Scalar>
+    const Matrix4<Scalar> Matrix4<Scalar>::OrthoInverse() const
+    {
+        const Vector3<Scalar> row0( m_data[r11], m_data[r12], m_data[r13] );
+        const Vector3<Scalar> row1( m_data[r21], m_data[r22], m_data[r23] );
+        const Vector3<Scalar> row2( m_data[r31], m_data[r32], m_data[r33] );
+        const Vector3<Scalar> translation = ( row0.ScalarMult( m_data[X] ) +
+                                              row1.ScalarMult( m_data[Y] ) +
+                                              row2.ScalarMult( m_data[Z] ) ).ScalarMult( Scalar( -1.0 ) );
+        Matrix4<Scalar> invMat;
+        invMat.SetFromColumns( row0, row1, row2, translation );
+        return invMat;
+    }
+
+    // The columns of R^-1 are the cross products of the rows of R over det(R),
+    // all whole (SIMD) vector operations.
+    template <typename Scalar>
+    void Matrix4<Scalar>::SetInverse( const Matrix4<Scalar>& mat )
+    {
+        const Vector3<Scalar> row0( mat.m_data[r11], mat.m_data[r12], mat.m_data[r13] );
+        const Vector3<Scalar> row1( mat.m_data[r21], mat.m_data[r22], mat.m_data[r23] );
+        const Vector3<Scalar> row2( mat.m_data[r31], mat.m_data[r32], mat.m_data[r33] );
+
+        const Vector3<Scalar> adj0 = row1.Cross( row2 );
+        const Vector3<Scalar> adj1 = row2.Cross( row0 );
+        const Vector3<Scalar> adj2 = row0.Cross( row1 );
+
+        // make sure the determinant is non-zero
+        const Scalar det = row0.Dot( adj0 );
+        if( fabs( det ) < Scalar( 1.0E-10 ) ) return;
+
+        const Scalar invDet = Scalar( 1.0 ) / det;
+        const Vector3<Scalar> col0 = adj0.ScalarMult( invDet );
+        const Vector3<Scalar> col1 = adj1.ScalarMult( invDet );
+        const Vector3<Scalar> col2 = adj2.ScalarMult( invDet );
+        const Vector3<Scalar> translation = ( col0.ScalarMult( mat.m_data[X] ) +
+                                              col1.ScalarMult( mat.m_data[Y] ) +
+                                              col2.ScalarMult( mat.m_data[Z] ) ).ScalarMult( Scalar( -1.0 ) );
+        SetFromColumns( col0, col1, col2, translation );
+    }
+
+    template <typename Scalar>
+    const Matrix4<Scalar> Matrix4<Scalar>::Inverse() const
+    {
+        Matrix4<Scalar> invMat;
+        invMat.SetInverse( *this );
+        return invMat;
+    }
+
     template <typename Scalar>
     void Matrix4<Scalar>::SetRotation3x3( const Matrix3<Scalar>& rotMat )
     {
@@ -37,11 +37,11 @@ NavLeg::NavLeg( Vector3<float> startPos,
          m_vArrow2.Set( halfPos - dir.ScalarMult(m_distanceNM * 0.1f), dir, downDir.ScalarMult( -1.0f ), c_colorGreen, m_distanceNM * 0.1f);     
      }
      
-     void NavLeg::Draw()
+     void NavLeg::Draw( LineBatch& batch )
      {
-         m_startLocator.Draw();
-         m_endLocator.Draw();
-         m_leg.Draw();
-         m_vArrow1.Draw();
-         m_vArrow2.Draw();
+         m_startLocator.Draw( batch );
+         m_endLocator.Draw( batch );
+         batch.Add( m_leg );
+         m_vArrow1.Draw( batch );
+         m_vArrow2.Draw( batch );
      }
\ No newline at end of file
@@ -29,7 +29,7 @@ public:
      const Vector3<float> getEndPos( void ) const { return m_endPos; }
      float                getTrack( void ) const { return m_TR; }
      
-     void Draw();
+     void Draw( LineBatch& batch );
 };
 
 #endif //__NAVLEG_H__
\ No newline at end of file
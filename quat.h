@@ -2,6 +2,7 @@
 #define __QUATERNION_H__
 
 #include <assert.h>
+#include <cstddef>
 #include "vector3.h"
 #include "vector4.h"
 
@@ -18,31 +19,31 @@ namespace GrapheneMath
 
     public:
         // Default ctor creates identity quaternion.
-        Quaternion(const Scalar& x = Scalar{},
-                   const Scalar& y = Scalar{},
-                   const Scalar& z = Scalar{},
-                   const Scalar& w = Scalar{})
+        constexpr Quaternion(const Scalar& x = Scalar{},
+                             const Scalar& y = Scalar{},
+                             const Scalar& z = Scalar{},
+                             const Scalar& w = Scalar{})
             : re(w), vec(x, y, z)
         {}
 
-        Quaternion(const Scalar& w, const Vector3<Scalar>& v)
+        constexpr Quaternion(const Scalar& w, const Vector3<Scalar>& v)
             :re(w), vec(v)
         {}
 
         // Explicit ctor creates quaternion from vector4.
-        explicit Quaternion(const Vector4<Scalar>& _vec)
-            : re(_vec.GetW()), vec(_vec.GetXYZ())
+        explicit constexpr Quaternion(const Vector4<Scalar>& _vec)
+            : re(_vec.GetW()), vec(_vec.GetX(), _vec.GetY(), _vec.GetZ())
         {}
 
-        inline const Scalar GetX() const { return vec.GetX(); }
-        inline const Scalar GetY() const { return vec.GetY(); }
-        inline const Scalar GetZ() const { return vec.GetZ(); }
+        constexpr Scalar GetX() const { return vec.GetX(); }
+        constexpr Scalar GetY() const { return vec.GetY(); }
+        constexpr Scalar GetZ() const { return vec.GetZ(); }
 
         // Function returns the real part of the quaternion.
-        inline const Scalar GetW() const { return re; }
+        constexpr Scalar GetW() const { return re; }
 
         // Function returns the vector part of the quaternion.
-        const Vector3<Scalar> GetXYZ() const { return vec; }
+        constexpr Vector3<Scalar> GetXYZ() const { return vec; }
 
         // Set quaternion with new real and vector parts.
         void Set( Scalar w, const Vector3<Scalar>& v );
@@ -50,10 +51,24 @@ namespace GrapheneMath
         // Function creates quaternion form unit axis and angle (in radians).
         void FromAxisAngle( const Vector3<Scalar>& axis, Scalar angle );
 
+        // Quaternion of the rotation about unit axis whose half angle has cosine
+        // cosHalf and sine sinHalf. Evaluated at compile time for constant input.
+        static constexpr Quaternion FromAxisCosSin( const Vector3<Scalar>& axis, Scalar cosHalf, Scalar sinHalf )
+        {
+            return Quaternion( axis.GetX() * sinHalf, axis.GetY() * sinHalf, axis.GetZ() * sinHalf, cosHalf );
+        }
+
+        // Compile-time FromAxisAngle for a fixed unit axis and angle (in radians),
+        // the half angle trigonometry uses ConstCos/ConstSin.
+        static constexpr Quaternion AxisAngle( const Vector3<Scalar>& axis, Scalar angle )
+        {
+            return FromAxisCosSin( axis, ConstCos( angle / Scalar( 2.0 ) ), ConstSin( angle / Scalar( 2.0 ) ) );
+        }
+
         // Function returns angle in radians.
         inline const Scalar GetAngle() const
         {
-            return(Scalar(2.0) * atan2(vec.Mag(), re));
+            return(Scalar(2.0) * Trig<Scalar>::Atan2(vec.Mag(), re));
         }
 
         // Multiplication operator which follows exact mathematical definition but
@@ -62,12 +77,12 @@ namespace GrapheneMath
         inline const Quaternion<Scalar> operator^( const Quaternion<Scalar>& p ) const;
 
         // Multiplication operator in its unwrapped and efficient implementation.
-        const Quaternion<Scalar> operator*(const Quaternion<Scalar>& p) const;
+        constexpr const Quaternion<Scalar> operator*(const Quaternion<Scalar>& p) const;
 
         // Complex conjugate postfix operator.
-        const Quaternion operator~() const
+        constexpr const Quaternion operator~() const
         {
-            return Quaternion(re, (vec.ScalarMult(Scalar(-1.0))));
+            return Quaternion(-vec.GetX(), -vec.GetY(), -vec.GetZ(), re);
         }
 
         const Scalar Mag() const
@@ -89,6 +104,20 @@ namespace GrapheneMath
             }
         }
 
+        // Four dimensional dot product, the cosine of half the angle between
+        // the rotations of two unit quaternions.
+        const Scalar Dot( const Quaternion& p ) const
+        {
+            return re * p.GetW() + vec.Dot( p.GetXYZ() );
+        }
+
+        // Natural logarithm of a unit quaternion ( cos(a), axis sin(a) ),
+        // the pure quaternion ( 0, axis a ).
+        const Quaternion Log() const;
+
+        // Exponential of a pure quaternion ( 0, axis a ), the inverse of Log.
+        const Quaternion Exp() const;
+
         // Function rotates input vector w with a quaternion i.e. it explicitly applies
         // quaternion rotation operator to that vector.
         // It returns new, rotated vector, extracted from the pure quaternion.
@@ -116,10 +145,29 @@ namespace GrapheneMath
   {
       assert( axis.IsUnit() );
       angle /= Scalar( 2.0 );
-      re = cos( angle );
-      vec = axis.ScalarMult( sin ( angle ) );
+      re = Trig<Scalar>::Cos( angle );
+      vec = axis.ScalarMult( Trig<Scalar>::Sin( angle ) );
   }
   
+  template <typename Scalar>
+  const Quaternion<Scalar> Quaternion<Scalar>::Log() const
+  {
+      const Scalar sinA = vec.Mag();
+      const Scalar a = Trig<Scalar>::Atan2( sinA, re );
+      // log( q ) ~ ( 0, v ) close to the identity.
+      const Scalar scale = ( sinA > Constants<Scalar>::NumTolerance() ) ? ( a / sinA ) : Scalar( 1.0 );
+      return Quaternion( Scalar( 0.0 ), vec.ScalarMult( scale ) );
+  }
+
+  template <typename Scalar>
+  const Quaternion<Scalar> Quaternion<Scalar>::Exp() const
+  {
+      const Scalar a = vec.Mag();
+      const Scalar sinA = Trig<Scalar>::Sin( a );
+      const Scalar scale = ( a > Constants<Scalar>::NumTolerance() ) ? ( sinA / a ) : Scalar( 1.0 );
+      return Quaternion( Trig<Scalar>::Cos( a ), vec.ScalarMult( scale ) );
+  }
+
   // Multiplication operator which follows exact mathematical definition but
   // becomes inefficient due to excessive usage of dot and cross product vector operators.
   // s = qp = qrpr - q  p + qrp + prq + q  p
@@ -134,7 +182,7 @@ namespace GrapheneMath
 
   // Multiplication operator in its unwrapped and efficient implementation.
   template <typename Scalar>
-  const Quaternion<Scalar> Quaternion<Scalar>::operator*(const Quaternion<Scalar>& p) const
+  constexpr const Quaternion<Scalar> Quaternion<Scalar>::operator*(const Quaternion<Scalar>& p) const
   {
       return Quaternion(
                 GetW() * p.GetX() + p.GetW() * vec.GetX() + vec.GetY() * p.GetZ() - vec.GetZ() * p.GetY(),
@@ -167,10 +215,126 @@ namespace GrapheneMath
       const Scalar exrMult = Scalar( 2.0 ) * re;
       const Scalar rMult = exrMult * re - Scalar( 1.0 );
       const Scalar eMult = Scalar( 2.0 ) * vec.Dot( w );
-      return Vector3<Scalar>(
-            rMult * w.GetX() + exrMult * (vec.GetY() * w.GetZ() - vec.GetZ() * w.GetY()) + eMult * vec.GetX(),
-            rMult * w.GetY() + exrMult * (vec.GetZ() * w.GetX() - vec.GetX() * w.GetZ()) + eMult * vec.GetY(),
-            rMult * w.GetZ() + exrMult * (vec.GetX() * w.GetY() - vec.GetY() * w.GetX()) + eMult * vec.GetZ() );
+
+      // Whole vector operations only, so that the SIMD Vector3 never goes
+      // through single components.
+      return w.ScalarMult( rMult ) + vec.Cross( w ).ScalarMult( exrMult ) + vec.ScalarMult( eMult );
+  }
+
+  // Function rotates 'count' vectors with quaternion q and translates them by 'offset':
+  // out[i] = q(in[i]) + offset. 'in' and 'out' may be the same array.
+  // The rotation is expanded once into the columns of its 3x3 matrix, each
+  // vector then costs three multiplies and three adds of whole (SIMD) vectors.
+  template <typename Scalar>
+  void RotateMany( const Quaternion<Scalar>& q,
+                   const Vector3<Scalar>* in,
+                   Vector3<Scalar>* out,
+                   size_t count,
+                   const Vector3<Scalar>& offset = Vector3<Scalar>() )
+  {
+      // Assuming q has unit length here.
+      const Vector3<Scalar> col0 = q.RotateFast( Vector3<Scalar>( Scalar( 1.0 ), Scalar( 0.0 ), Scalar( 0.0 ) ) );
+      const Vector3<Scalar> col1 = q.RotateFast( Vector3<Scalar>( Scalar( 0.0 ), Scalar( 1.0 ), Scalar( 0.0 ) ) );
+      const Vector3<Scalar> col2 = q.RotateFast( Vector3<Scalar>( Scalar( 0.0 ), Scalar( 0.0 ), Scalar( 1.0 ) ) );
+
+      for( size_t i = 0; i < count; ++i )
+      {
+          const Vector3<Scalar>& v = in[i];
+          out[i] = col0.ScalarMult( v.GetX() ) + col1.ScalarMult( v.GetY() ) + col2.ScalarMult( v.GetZ() ) + offset;
+      }
+  }
+
+  // Interpolation between unit quaternions a (t = 0) and b (t = 1), e.g. the
+  // attitudes of the last two physics steps at render time. All of them take
+  // the shorter way round, q and -q being the same rotation.
+
+  // Normalised linear interpolation. Constant speed only for small angles,
+  // which is the case between physics steps, and the cheapest.
+  template <typename Scalar>
+  const Quaternion<Scalar> Nlerp( const Quaternion<Scalar>& a, const Quaternion<Scalar>& b, Scalar t )
+  {
+      const Scalar wa = Scalar( 1.0 ) - t;
+      const Scalar wb = ( a.Dot( b ) < Scalar( 0.0 ) ) ? -t : t;
+      Quaternion<Scalar> result( wa * a.GetW() + wb * b.GetW(),
+                                 a.GetXYZ().ScalarMult( wa ) + b.GetXYZ().ScalarMult( wb ) );
+      result.Normalise();
+      return result;
+  }
+
+  // Spherical linear interpolation, constant angular speed:
+  // slerp( a, b, t ) = ( sin( (1-t)h ) a + sin( th ) b ) / sin( h ), cos( h ) = a . b
+  // Falls back to Nlerp when sin( h ) is within NumTolerance.
+  template <typename Scalar>
+  const Quaternion<Scalar> Slerp( const Quaternion<Scalar>& a, const Quaternion<Scalar>& b, Scalar t )
+  {
+      const Scalar dot  = a.Dot( b );
+      const Scalar sign = ( dot < Scalar( 0.0 ) ) ? Scalar( -1.0 ) : Scalar( 1.0 );
+      const Scalar cosH = sign * dot;
+      const Scalar sinH = sqrt( ( Scalar( 1.0 ) - cosH ) * ( Scalar( 1.0 ) + cosH ) );
+      if( !( sinH > Constants<Scalar>::NumTolerance() ) )
+      {
+          return Nlerp( a, b, t );
+      }
+
+      const Scalar h      = Trig<Scalar>::Atan2( sinH, cosH );
+      const Scalar invSin = Scalar( 1.0 ) / sinH;
+      const Scalar wa     = Trig<Scalar>::Sin( ( Scalar( 1.0 ) - t ) * h ) * invSin;
+      const Scalar wb     = sign * Trig<Scalar>::Sin( t * h ) * invSin;
+      return Quaternion<Scalar>( wa * a.GetW() + wb * b.GetW(),
+                                 a.GetXYZ().ScalarMult( wa ) + b.GetXYZ().ScalarMult( wb ) );
+  }
+
+  // Squad control point of key q1 between its neighbours q0 and q2:
+  // s1 = q1 exp( -( log( q1* q0 ) + log( q1* q2 ) ) / 4 )
+  template <typename Scalar>
+  const Quaternion<Scalar> SquadControlPoint( const Quaternion<Scalar>& q0, const Quaternion<Scalar>& q1, const Quaternion<Scalar>& q2 )
+  {
+      const Quaternion<Scalar> inv1 = ~q1;
+      // Neighbours on the hemisphere of q1.
+      const Quaternion<Scalar> to0 = inv1 * ( ( q1.Dot( q0 ) < Scalar( 0.0 ) ) ? Quaternion<Scalar>( -q0.GetW(), q0.GetXYZ().ScalarMult( Scalar( -1.0 ) ) ) : q0 );
+      const Quaternion<Scalar> to2 = inv1 * ( ( q1.Dot( q2 ) < Scalar( 0.0 ) ) ? Quaternion<Scalar>( -q2.GetW(), q2.GetXYZ().ScalarMult( Scalar( -1.0 ) ) ) : q2 );
+      const Vector3<Scalar> sum = to0.Log().GetXYZ() + to2.Log().GetXYZ();
+      return q1 * Quaternion<Scalar>( Scalar( 0.0 ), sum.ScalarMult( Scalar( -0.25 ) ) ).Exp();
+  }
+
+  // Spherical cubic interpolation from key q1 (t = 0) to key q2 (t = 1) with
+  // their control points s1, s2 (SquadControlPoint). Tangent continuous across
+  // keys, unlike Slerp over a sequence of keys:
+  // squad = slerp( slerp( q1, q2, t ), slerp( s1, s2, t ), 2t(1 - t) )
+  template <typename Scalar>
+  const Quaternion<Scalar> Squad( const Quaternion<Scalar>& q1, const Quaternion<Scalar>& q2,
+                                  const Quaternion<Scalar>& s1, const Quaternion<Scalar>& s2, Scalar t )
+  {
+      return Slerp( Slerp( q1, q2, t ), Slerp( s1, s2, t ), Scalar( 2.0 ) * t * ( Scalar( 1.0 ) - t ) );
+  }
+
+  // Batched forms for a fleet: out[i] interpolates from[i] and to[i] with the
+  // same t, the render time between the two physics steps.
+  // 'out' may be the same array as 'from' or 'to'.
+  template <typename Scalar>
+  void NlerpMany( const Quaternion<Scalar>* from,
+                  const Quaternion<Scalar>* to,
+                  Quaternion<Scalar>* out,
+                  size_t count,
+                  Scalar t )
+  {
+      for( size_t i = 0; i < count; ++i )
+      {
+          out[i] = Nlerp( from[i], to[i], t );
+      }
+  }
+
+  template <typename Scalar>
+  void SlerpMany( const Quaternion<Scalar>* from,
+                  const Quaternion<Scalar>* to,
+                  Quaternion<Scalar>* out,
+                  size_t count,
+                  Scalar t )
+  {
+      for( size_t i = 0; i < count; ++i )
+      {
+          out[i] = Slerp( from[i], to[i], t );
+      }
   }
 
 }  //< End of namespace GrapheneMath
@@ -0,0 +1,163 @@
+#ifndef __SIMD_TRAITS_H__
+#define __SIMD_TRAITS_H__
+
+#include <math.h>
+
+// SSE is used on x86 when the compiler targets it (SSE2 is always there on
+// x86-64, SSE4.1 with -msse4.1). Define GRAPHENE_NO_SIMD to force the scalar code.
+#if !defined( GRAPHENE_NO_SIMD ) && ( defined( __SSE2__ ) || defined( _M_X64 ) )
+#define GRAPHENE_SIMD 1
+#include <emmintrin.h>
+#if defined( __SSE4_1__ )
+#include <smmintrin.h>
+#endif
+#else
+#define GRAPHENE_SIMD 0
+#endif
+
+namespace GrapheneMath
+{
+    // Four lane vector operations on 16 byte aligned arrays of Scalar.
+    // Vector3 and Vector4 select their SIMD specialisation with 'enabled',
+    // Vector3 keeps its fourth lane at zero.
+    template <typename Scalar>
+    struct SimdTraits
+    {
+        static const bool enabled = false;
+    };
+
+#if GRAPHENE_SIMD
+    template <>
+    struct SimdTraits<float>
+    {
+        static const bool enabled = true;
+
+        static inline void Add( const float* a, const float* b, float* out )
+        {
+            _mm_store_ps( out, _mm_add_ps( _mm_load_ps( a ), _mm_load_ps( b ) ) );
+        }
+
+        static inline void Sub( const float* a, const float* b, float* out )
+        {
+            _mm_store_ps( out, _mm_sub_ps( _mm_load_ps( a ), _mm_load_ps( b ) ) );
+        }
+
+        static inline void Scale( const float* a, float scalar, float* out )
+        {
+            _mm_store_ps( out, _mm_mul_ps( _mm_load_ps( a ), _mm_set1_ps( scalar ) ) );
+        }
+
+        static inline void Div( const float* a, float scalar, float* out )
+        {
+            _mm_store_ps( out, _mm_div_ps( _mm_load_ps( a ), _mm_set1_ps( scalar ) ) );
+        }
+
+        static inline float Dot( const float* a, const float* b )
+        {
+#if defined( __SSE4_1__ )
+            return _mm_cvtss_f32( _mm_dp_ps( _mm_load_ps( a ), _mm_load_ps( b ), 0xFF ) );
+#else
+            const __m128 mul  = _mm_mul_ps( _mm_load_ps( a ), _mm_load_ps( b ) );
+            const __m128 shuf = _mm_shuffle_ps( mul, mul, _MM_SHUFFLE( 2, 3, 0, 1 ) ); //< y x w z
+            const __m128 sums = _mm_add_ps( mul, shuf );                               //< x+y . z+w .
+            return _mm_cvtss_f32( _mm_add_ss( sums, _mm_movehl_ps( shuf, sums ) ) );
+#endif
+        }
+
+        // Cross product of the first three lanes, the fourth lane of out is
+        // a.w * b.w - a.w * b.w = 0.
+        static inline void Cross( const float* a, const float* b, float* out )
+        {
+            const __m128 va    = _mm_load_ps( a );
+            const __m128 vb    = _mm_load_ps( b );
+            const __m128 a_yzx = _mm_shuffle_ps( va, va, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+            const __m128 b_yzx = _mm_shuffle_ps( vb, vb, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+            const __m128 c     = _mm_sub_ps( _mm_mul_ps( va, b_yzx ), _mm_mul_ps( a_yzx, vb ) ); //< z x y
+            _mm_store_ps( out, _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 0, 2, 1 ) ) );
+        }
+    };
+
+    // Four doubles are two SSE2 registers. AVX is not used: with only 16 byte
+    // alignment guaranteed (std::vector, new) half of the 256 bit loads split
+    // across cache lines and measured slower than the portable code.
+    template <>
+    struct SimdTraits<double>
+    {
+        static const bool enabled = true;
+
+        static inline void Add( const double* a, const double* b, double* out )
+        {
+            _mm_store_pd( out,     _mm_add_pd( _mm_load_pd( a ),     _mm_load_pd( b ) ) );
+            _mm_store_pd( out + 2, _mm_add_pd( _mm_load_pd( a + 2 ), _mm_load_pd( b + 2 ) ) );
+        }
+
+        static inline void Sub( const double* a, const double* b, double* out )
+        {
+            _mm_store_pd( out,     _mm_sub_pd( _mm_load_pd( a ),     _mm_load_pd( b ) ) );
+            _mm_store_pd( out + 2, _mm_sub_pd( _mm_load_pd( a + 2 ), _mm_load_pd( b + 2 ) ) );
+        }
+
+        static inline void Scale( const double* a, double scalar, double* out )
+        {
+            const __m128d s = _mm_set1_pd( scalar );
+            _mm_store_pd( out,     _mm_mul_pd( _mm_load_pd( a ),     s ) );
+            _mm_store_pd( out + 2, _mm_mul_pd( _mm_load_pd( a + 2 ), s ) );
+        }
+
+        static inline void Div( const double* a, double scalar, double* out )
+        {
+            const __m128d s = _mm_set1_pd( scalar );
+            _mm_store_pd( out,     _mm_div_pd( _mm_load_pd( a ),     s ) );
+            _mm_store_pd( out + 2, _mm_div_pd( _mm_load_pd( a + 2 ), s ) );
+        }
+
+        static inline double Dot( const double* a, const double* b )
+        {
+            const __m128d sum = _mm_add_pd( _mm_mul_pd( _mm_load_pd( a ),     _mm_load_pd( b ) ),
+                                            _mm_mul_pd( _mm_load_pd( a + 2 ), _mm_load_pd( b + 2 ) ) );
+            return _mm_cvtsd_f64( _mm_add_sd( sum, _mm_unpackhi_pd( sum, sum ) ) );
+        }
+
+        // Cross product of the first three lanes, the fourth lane of out is 0.
+        // x y = a.yz * b.zx - a.zx * b.yz, z = a.x * b.y - a.y * b.x
+        static inline void Cross( const double* a, const double* b, double* out )
+        {
+            const __m128d a_xy = _mm_load_pd( a );
+            const __m128d a_z0 = _mm_load_pd( a + 2 );
+            const __m128d b_xy = _mm_load_pd( b );
+            const __m128d b_z0 = _mm_load_pd( b + 2 );
+            const __m128d a_yz = _mm_shuffle_pd( a_xy, a_z0, 1 );
+            const __m128d a_zx = _mm_shuffle_pd( a_z0, a_xy, 0 );
+            const __m128d b_yz = _mm_shuffle_pd( b_xy, b_z0, 1 );
+            const __m128d b_zx = _mm_shuffle_pd( b_z0, b_xy, 0 );
+            const __m128d m    = _mm_mul_pd( a_xy, _mm_shuffle_pd( b_xy, b_xy, 1 ) ); //< x*by y*bx
+            const __m128d z    = _mm_sub_sd( m, _mm_unpackhi_pd( m, m ) );
+
+            _mm_store_pd( out,     _mm_sub_pd( _mm_mul_pd( a_yz, b_zx ), _mm_mul_pd( a_zx, b_yz ) ) );
+            _mm_store_pd( out + 2, _mm_move_sd( _mm_setzero_pd(), z ) );
+        }
+
+        // 4x4 row-major product out = a * b, out must not alias a or b.
+        // Row i of out is the sum of the rows of b weighted by row i of a,
+        // each row as two pairs.
+        static inline void MatMul4( const double* a, const double* b, double* out )
+        {
+            for( int i = 0; i < 16; i += 4 )
+            {
+                const __m128d s0 = _mm_set1_pd( a[i] );
+                const __m128d s1 = _mm_set1_pd( a[i + 1] );
+                const __m128d s2 = _mm_set1_pd( a[i + 2] );
+                const __m128d s3 = _mm_set1_pd( a[i + 3] );
+                const __m128d lo = _mm_add_pd( _mm_add_pd( _mm_mul_pd( s0, _mm_load_pd( b ) ),      _mm_mul_pd( s1, _mm_load_pd( b + 4 ) ) ),
+                                               _mm_add_pd( _mm_mul_pd( s2, _mm_load_pd( b + 8 ) ),  _mm_mul_pd( s3, _mm_load_pd( b + 12 ) ) ) );
+                const __m128d hi = _mm_add_pd( _mm_add_pd( _mm_mul_pd( s0, _mm_load_pd( b + 2 ) ),  _mm_mul_pd( s1, _mm_load_pd( b + 6 ) ) ),
+                                               _mm_add_pd( _mm_mul_pd( s2, _mm_load_pd( b + 10 ) ), _mm_mul_pd( s3, _mm_load_pd( b + 14 ) ) ) );
+                _mm_store_pd( out + i,     lo );
+                _mm_store_pd( out + i + 2, hi );
+            }
+        }
+    };
+#endif // GRAPHENE_SIMD
+
+}  //< End of GrapheneMath namespace.
+#endif // __SIMD_TRAITS_H__
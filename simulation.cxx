@@ -96,11 +96,11 @@ void Simulation::Update()
       m_dsp.Write(30, 9, "TAS: ", TAS.Mag(), "[kts]" ); 
       
       // Obtain real track from simulation.
-      const Vector3<float> NorthT( 1.0f, 0.0f, 0.0f );
+      static constexpr Vector3<float> NorthT( 1.0f, 0.0f, 0.0f );
       Vector3<float> vNorm = v;
       vNorm.Normalise();
       float realTR = Rad2Deg( vNorm.GetAngle( NorthT ) ); // GetAngle returns angle in range 0 - 180 DEG;
-      const Vector3<float> EastT( 0.0f, 0.0f, 1.0f );
+      static constexpr Vector3<float> EastT( 0.0f, 0.0f, 1.0f );
       realTR = ( v.Dot( EastT ) < 0.0f ) ? (360.0f - realTR) : realTR; //< make sure the angle is relative to N measured clockwise
       m_dsp.Write(0, 10, "TR:  ", realTR, "[°T]" );
       
@@ -138,18 +138,17 @@ void Simulation::Update()
       
 }
 
-void Simulation::Draw()
+void Simulation::Draw( LineBatch& batch )
 {
     // Draw World reference frame.
-    xAxisLine.Draw();
-    yAxisLine.Draw();
-    zAxisLine.Draw();
+    batch.Add( xAxisLine );
+    batch.Add( yAxisLine );
+    batch.Add( zAxisLine );
 
-    m_leg01.Draw();
-    m_wv.Draw();
+    m_leg01.Draw( batch );
+    m_wv.Draw( batch );
 
-    GLLine vel ( 0.0, m_C152.GetVelocity(), colorRed );
-    vel.Draw();
+    batch.Add( zeroVec, m_C152.GetVelocity(), colorRed );
 
     m_C152.Draw();
 }
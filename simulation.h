@@ -12,6 +12,7 @@
 #include "quat.h"
 #include "matrix4.h"
 #include "glLine.h"
+#include "lineBatch.h"
 #include "xlocator.h"
 #include "varrow2d.h"
 #include "wv.h"
@@ -63,7 +64,7 @@ public:
     //Application Module overrides
     void Initialise();
     void Update();
-    void Draw();
+    void Draw( LineBatch& batch );
 
     void calcTriangle();
 };
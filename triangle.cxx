@@ -1,10 +1,17 @@
-#include "triangle.h" 
+#include <algorithm>
+#include "triangle.h"
 
-const double TriangleOfVelocitiesSolver::THREE_SIXTY_DEG = 360.0;
-const double TriangleOfVelocitiesSolver::ONE_EIGHTY_DEG  = 180.0;
+constexpr double TriangleOfVelocitiesSolver::THREE_SIXTY_DEG;
+constexpr double TriangleOfVelocitiesSolver::ONE_EIGHTY_DEG;
+constexpr double TriangleOfVelocitiesSolver::DEG_TO_RAD;
+constexpr double TriangleOfVelocitiesSolver::RAD_TO_DEG;
+const double TriangleOfVelocitiesSolver::SOLUTION_TOLERANCE = 1E-9;
 
 TriangleOfVelocitiesSolver::TriangleOfVelocitiesSolver()
     : m_mask( 0 )
+    , m_stats( NULL )
+    , m_callback( NULL )
+    , m_callbackData( NULL )
     {}
 
 void TriangleOfVelocitiesSolver::solve( TriangleOfVelocities& tov )
@@ -103,16 +110,16 @@ void TriangleOfVelocitiesSolver::solve( TriangleOfVelocities& tov )
     }
     /////////////////////////////////////////////////////
     
-    double arg = sin( Deg2Rad(TR_W)) * (tov.V / tov.TAS);
+    double arg = Trig<double>::Sin( Deg2Rad(TR_W)) * (tov.V / tov.TAS);
     arg = (arg > 1.0) ? 1.0 : arg;
     arg = (arg < -1.0) ? -1.0 : arg; 
     
     if(leftDrift)
     {
-        tov.HDG = fabs(Deg2Rad( tov.TR ) - asin( arg )); 
+        tov.HDG = fabs(Deg2Rad( tov.TR ) - Trig<double>::Asin( arg )); 
     }else
     {
-        tov.HDG = Deg2Rad( tov.TR ) + asin( arg );
+        tov.HDG = Deg2Rad( tov.TR ) + Trig<double>::Asin( arg );
     }
     
     
@@ -141,7 +148,7 @@ void TriangleOfVelocitiesSolver::solve( TriangleOfVelocities& tov )
     //const double sumAngleDEG = HDG_TR + TR_W + W_HDG;
     //std::cout << "<)SUM: " << sumAngleDEG <<" [°T]" << "\n";
 
-    tov.GS = tov.V * ( sin( Deg2Rad(W_HDG)) / (sin( Deg2Rad(HDG_TR) )));
+    tov.GS = tov.V * ( Trig<double>::Sin( Deg2Rad(W_HDG)) / (Trig<double>::Sin( Deg2Rad(HDG_TR) )));
     
     //std::cout << "HDG "  << tov.HDG << " [°T]"  << "\n";
     //std::cout << "TAS "  << tov.TAS << " [kts]" << "\n";
@@ -155,6 +162,127 @@ void TriangleOfVelocitiesSolver::solve( TriangleOfVelocities& tov )
     assert( isSane( tov ) );
 }
 
+void TriangleOfVelocitiesSolver::solve( const TriangleOfVelocitiesSoA& batch ) const
+{
+    solveBatch< eFindHdgGs >( batch );
+}
+
+bool TriangleOfVelocitiesSolver::isSolvable( uint8_t mask )
+{
+    switch( mask )
+    {
+        case eFindHdgGs:
+        case eFindWind:
+        case eFindTrGs:
+        case eFindHdgTas:
+        case eFindTasGs:
+        case eFindTrTas:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool TriangleOfVelocitiesSolver::solveMasked( TriangleOfVelocities& tov ) const
+{
+    if( !isSolvable( m_mask ) )
+    {
+        return false;
+    }
+
+    TriangleOfVelocitiesSoA batch;
+    batch.TR    = &tov.TR;
+    batch.TAS   = &tov.TAS;
+    batch.W     = &tov.W;
+    batch.V     = &tov.V;
+    batch.HDG   = &tov.HDG;
+    batch.GS    = &tov.GS;
+    batch.count = 1;
+
+    return solveMasked( batch );
+}
+
+bool TriangleOfVelocitiesSolver::solveMasked( const TriangleOfVelocitiesSoA& batch ) const
+{
+    switch( m_mask )
+    {
+        case eFindHdgGs:  solveBatch< eFindHdgGs,  GRAPHENE_FAST_TRIG >( batch ); return true;
+        case eFindWind:   solveBatch< eFindWind,   GRAPHENE_FAST_TRIG >( batch ); return true;
+        case eFindTrGs:   solveBatch< eFindTrGs,   GRAPHENE_FAST_TRIG >( batch ); return true;
+        case eFindHdgTas: solveBatch< eFindHdgTas, GRAPHENE_FAST_TRIG >( batch ); return true;
+        case eFindTasGs:  solveBatch< eFindTasGs,  GRAPHENE_FAST_TRIG >( batch ); return true;
+        case eFindTrTas:  solveBatch< eFindTrTas,  GRAPHENE_FAST_TRIG >( batch ); return true;
+
+        default:
+            return false;
+    }
+}
+
+// Same wind-relative sine rule as the batch solver, with the second solution:
+// WCA2 = 180 DEG - WCA1, GS2 = -TAS * cos( WCA1 ) - V * cos( W - TR ).
+// A solution is only valid when it makes progress along the track (GS > 0).
+// With TAS < V that is the case for both or for none of them.
+const TriangleSolution TriangleOfVelocitiesSolver::solveSilent( const TriangleOfVelocities& tov ) const
+{
+    TriangleSolution solution;
+
+    const double TR_RAD   = tov.TR * DEG_TO_RAD;
+    const double relWind  = tov.W * DEG_TO_RAD - TR_RAD; //< <)W,TR (wind FROM)
+    const double headWind = tov.V * Trig<double>::Cos( relWind );
+    const double sinWCA   = ( tov.TAS > 0.0 ) ? ( tov.V * Trig<double>::Sin( relWind ) ) / tov.TAS : 2.0;
+
+    if( fabs( sinWCA ) > 1.0 + SOLUTION_TOLERANCE )
+    {
+        solution.type = TriangleSolution::eImpossible;
+    }
+    else if( fabs( sinWCA ) >= 1.0 - SOLUTION_TOLERANCE )
+    {
+        // <)HDG,GS = 90 DEG
+        solution.HDG[0] = wrapAngle( tov.TR + ( ( sinWCA > 0.0 ) ? 90.0 : -90.0 ) );
+        solution.GS[0]  = -headWind;
+        solution.numSolutions = ( solution.GS[0] > SOLUTION_TOLERANCE ) ? 1 : 0;
+        solution.type = ( solution.numSolutions ) ? TriangleSolution::eTangent : TriangleSolution::eImpossible;
+    }
+    else
+    {
+        const double WCA    = Trig<double>::Asin( sinWCA ) * RAD_TO_DEG;
+        const double TAScos = tov.TAS * sqrt( 1.0 - sinWCA * sinWCA );
+
+        solution.HDG[0] = wrapAngle( tov.TR + WCA );
+        solution.GS[0]  = TAScos - headWind;
+        solution.HDG[1] = wrapAngle( tov.TR + ONE_EIGHTY_DEG - WCA );
+        solution.GS[1]  = -TAScos - headWind;
+
+        if( solution.GS[0] <= SOLUTION_TOLERANCE )
+        {
+            solution.type = TriangleSolution::eImpossible;
+        }
+        else if( tov.TAS >= tov.V || solution.GS[1] <= SOLUTION_TOLERANCE )
+        {
+            solution.type = TriangleSolution::eSingle;
+            solution.numSolutions = 1;
+        }
+        else
+        {
+            solution.type = TriangleSolution::eTwo;
+            solution.numSolutions = 2;
+        }
+    }
+
+    if( m_stats )
+    {
+        ++m_stats->count[ solution.type ];
+    }
+
+    if( m_callback )
+    {
+        m_callback( tov, solution, m_callbackData );
+    }
+
+    return solution;
+}
+
 // law of cosines
 // c2 = a2 + b2 - 2ab cos( C )
 // b2 = a2 + c2 - 2ac cos( B )
@@ -184,27 +312,22 @@ void TriangleOfVelocitiesSolver::solve( TriangleOfVelocities& tov )
 // >>>> HDG = 280;
 
     
-void TriangleOfVelocitiesSolver::solveVecDirLength()
+void TriangleOfVelocitiesSolver::solveVecDirLength( TriangleOfVelocities& tov ) const
 {
-    std::cout << "Triangle solve()" << "\n";
-    std::cout << "----------------" << "\n";
-
     // basic (most common example)
     // |0|0| 0 | 1 |1|1|1 |0 | (00011110)
     // vector (W/V), dir(TR), length(TAS)
-    double TR  = 150;
-    double TAS = 100.0;
-    double W   = 0.0;
-    double V   = 30.0;
-    double HDG = 0.0; //<?
-    double GS  = 0.0; //<?
+    const double TR  = tov.TR;
+    const double TAS = tov.TAS;
+    const double V   = tov.V;
+    double       W   = tov.W;
 
     // Reverse Wind direction, handling edge cases.
-    if( abs( W - ONE_EIGHTY_DEG ) < NUM_TOLERANCE ) //< wind is FROM 180 T (S)
+    if( fabs( W - ONE_EIGHTY_DEG ) < NUM_TOLERANCE ) //< wind is FROM 180 T (S)
     {
         W = 0.0; // TO N
     }
-    else if( abs( W ) < NUM_TOLERANCE ) //< wind is FROM 0 T (N)
+    else if( fabs( W ) < NUM_TOLERANCE ) //< wind is FROM 0 T (N)
     {
         W = ONE_EIGHTY_DEG; // TO S
     }
@@ -212,24 +335,23 @@ void TriangleOfVelocitiesSolver::solveVecDirLength()
     {
          W = ( W < ONE_EIGHTY_DEG ) ? ( W + ONE_EIGHTY_DEG ) : ( W - ONE_EIGHTY_DEG ); // TO
     }
-    
-    std::cout << "W(to) " << W <<" [°T]" << "\n";
 
     double W_TR = ( W - TR < 0.0 ) ? 360.0 + (W - TR) : (W - TR);
-    W_TR = Deg2Rad( W_TR ); // to RAD
+    W_TR = W_TR * DEG_TO_RAD; // to RAD
 
     // from delta (two solutions, one is negative, choose positive)
-    const double GS1 = ( 2.0 * V * cos(W_TR) + sqrt( 4.0 * V * V* cos( W_TR ) * cos( W_TR ) - 4.0*V*V + 4.0*TAS*TAS )) / 2.0;
-    const double GS2 = ( 2.0 * V * cos(W_TR) - sqrt( 4.0 * V * V* cos( W_TR ) * cos( W_TR ) - 4.0*V*V + 4.0*TAS*TAS )) / 2.0;
-    //std::cout << "GS1 " << GS1 << "\n";
-    //std::cout << "GS2 " << GS2 << "\n";
+    const double cosW_TR = Trig<double>::Cos( W_TR );
+    const double sqrtDelta = sqrt( 4.0 * V * V * cosW_TR * cosW_TR - 4.0*V*V + 4.0*TAS*TAS );
+    const double GS1 = ( 2.0 * V * cosW_TR + sqrtDelta ) / 2.0;
+    const double GS2 = ( 2.0 * V * cosW_TR - sqrtDelta ) / 2.0;
     
     // Select the solution with positive GS.
-    GS = ( GS1 > 0 ) ? GS1 : GS2;
-    std::cout << "GS " << GS << " [kts]" << "\n";
+    const double GS = ( GS1 > 0 ) ? GS1 : GS2;
     
-    double HDG_TR_RAD = acos( (-V*V + TAS*TAS + GS*GS) / ( 2.0 * TAS * GS ) ); //< this is the drift angle DA
-    double HDG_TR_DEG = Rad2Deg( HDG_TR_RAD );
+    double cosDA = (-V*V + TAS*TAS + GS*GS) / ( 2.0 * TAS * GS );
+    cosDA = ( cosDA > 1.0 ) ? 1.0 : cosDA;
+    cosDA = ( cosDA < -1.0 ) ? -1.0 : cosDA;
+    const double HDG_TR_DEG = Trig<double>::Acos( cosDA ) * RAD_TO_DEG; //< this is the drift angle DA
 
     // To work out whether to add or subtract the drift angle to the track to compensate for wind,
     // we can use the angle between the track and the wind: <)W,TR
@@ -241,74 +363,84 @@ void TriangleOfVelocitiesSolver::solveVecDirLength()
     
     if( W < TR )
     {
-        if( TR-W < ONE_EIGHTY_DEG )
-        {
-            std::cout << "DA " << HDG_TR_DEG << " [°] L (port)" << "\n";
-            leftDrift = true;
-        }
-        else
-        {
-            std::cout << "DA " << HDG_TR_DEG << " [°] R (port)" << "\n";
-            leftDrift = false;
-        }
+        leftDrift = ( TR-W < ONE_EIGHTY_DEG );
     }
     else // W > TR
     {
-        if( W-TR < ONE_EIGHTY_DEG )
-        {
-            std::cout << "DA " << HDG_TR_DEG << " [°] R (port)" << "\n";
-            leftDrift = false;
-        }
-        else
-        {
-            std::cout << "DA " << HDG_TR_DEG << " [°] L (port)" << "\n";
-            leftDrift = true;
-        }
+        leftDrift = !( W-TR < ONE_EIGHTY_DEG );
     }
 
-    HDG = ( leftDrift ) ? ( TR + HDG_TR_DEG ) : ( TR - HDG_TR_DEG );
+    double HDG = ( leftDrift ) ? ( TR + HDG_TR_DEG ) : ( TR - HDG_TR_DEG );
 
     // Wrap around to 360.
-    HDG = ( HDG > THREE_SIXTY_DEG ) ? ( HDG - THREE_SIXTY_DEG) : HDG;
+    HDG = ( HDG >= THREE_SIXTY_DEG ) ? ( HDG - THREE_SIXTY_DEG) : HDG;
     HDG = ( HDG < 0.0 ) ? ( HDG + THREE_SIXTY_DEG) : HDG;
 
-    std::cout << "HDG " << HDG <<" [°T]" << "\n";
-    std::cin >> W;
+    tov.HDG = HDG;
+    tov.GS  = GS;
 }
 
-// Generic formulae (sine rule).
+// Generic formulae (sine rule), W as direction TO.
 // 3 side lengths, 3 angles, 4 known values
 //
 //        V                TAS                GS
 // ---------------  = -------------  = --------------
 // sin( HDG - TR )    sin( TR - W )    sin( HDG - W )
 //
-void TriangleOfVelocitiesSolver::solveVecDirLength2()
+void TriangleOfVelocitiesSolver::solveVecDirLength2( TriangleOfVelocities& tov ) const
 {
-    double TR  = 150.0;
-    double TAS = 100.0;
-    double W   = 0.0;
-    double V   = 30.0;
-    double HDG = 0.0; //<?
-    double GS  = 0.0; //<?
-
     // HDG = TR + asin( (V * sin( TR - W )) / TAS )
     // GS  = (TAS * sin( HDG - W )) / sin(TR - W)
 
-    W += ONE_EIGHTY_DEG;
+    double W = tov.W + ONE_EIGHTY_DEG;
     W = ( W > THREE_SIXTY_DEG ) ? ( W - THREE_SIXTY_DEG) : W;
 
     // Convert all directions to RAD.
-    W = Deg2Rad(W);
-    TR = Deg2Rad(TR);
-    
-    const double arg = (V * sin( TR-W )) / TAS; //< TODO: Make sure arg is clamped to the asin domain.
-    HDG = TR + asin( arg );
-    GS = (TAS * sin( HDG-W )) / sin(TR-W); //< TODO: Special case, avoid 0 devision.
- 
-    std::cout << "HDG " << Rad2Deg(HDG) <<" [°T]" << "\n";
-    std::cout << "GS " << GS << " [kts]" << "\n";
-    std::cin >> W;
+    W = W * DEG_TO_RAD;
+    const double TR = tov.TR * DEG_TO_RAD;
+    const double sinTR_W = Trig<double>::Sin( TR-W );
+
+    double arg = (tov.V * sinTR_W) / tov.TAS;
+    arg = ( arg > 1.0 ) ? 1.0 : arg;
+    arg = ( arg < -1.0 ) ? -1.0 : arg;
+    const double HDG = TR + Trig<double>::Asin( arg );
+
+    // Wind along the track (head or tail), no drift and the sine rule degenerates.
+    tov.GS = ( fabs( sinTR_W ) > SOLUTION_TOLERANCE ) ? (tov.TAS * Trig<double>::Sin( HDG-W )) / sinTR_W
+                                                      : tov.TAS + tov.V * Trig<double>::Cos( TR-W );
+    tov.HDG = TriangleKernelBase::wrap360( HDG * RAD_TO_DEG );
+}
+
+// Vector algebra, no trigonometric identities at all.
+// Track and wind are built as vectors (North is x axis, clockwise rotation about
+// the down axis, as in WV::Set), the wind is split into components along and
+// across the track. The air vector has to cancel the crosswind and keep |TAS|.
+void TriangleOfVelocitiesSolver::solveVectorAlgebra( TriangleOfVelocities& tov ) const
+{
+    const Vector3<double> dirNorth( 1.0, 0.0, 0.0 );
+    const Vector3<double> downDir( 0.0, -1.0, 0.0 );
+    const Vector3<double> dirEast( 0.0, 0.0, 1.0 );
+
+    Quaternion<double> rot;
+    rot.FromAxisAngle( downDir, tov.TR * DEG_TO_RAD );
+    const Vector3<double> track = rot.RotateFast( dirNorth );
+
+    rot.FromAxisAngle( downDir, tov.W * DEG_TO_RAD );
+    const Vector3<double> wind = rot.RotateFast( dirNorth ).ScalarMult( -tov.V ); //< direction TO
+
+    const double          alongTrack = wind.Dot( track );
+    const Vector3<double> crossTrack = wind - track.ScalarMult( alongTrack );
+
+    // Clamped like the asin argument of the other formulations.
+    const double crossSq = std::min( crossTrack.Dot( crossTrack ), tov.TAS * tov.TAS );
+    const double TASAlongTrack = sqrt( tov.TAS * tov.TAS - crossSq );
+
+    Vector3<double> air = track.ScalarMult( TASAlongTrack ) - crossTrack;
+    tov.GS = TASAlongTrack + alongTrack;
+
+    air.Normalise();
+    const double HDG = Rad2Deg( air.GetAngle( dirNorth ) ); //< 0 - 180 DEG
+    tov.HDG = ( air.Dot( dirEast ) < 0.0 ) ? ( THREE_SIXTY_DEG - HDG ) : HDG;
 }
 
 double TriangleOfVelocitiesSolver::invertWind( double windFromDeg )
@@ -318,6 +450,12 @@ double TriangleOfVelocitiesSolver::invertWind( double windFromDeg )
     return windFromDeg;
 }
 
+double TriangleOfVelocitiesSolver::wrapAngle( double angleDeg ) const
+{
+    angleDeg = fmod( angleDeg, THREE_SIXTY_DEG );
+    return ( angleDeg < 0.0 ) ? ( angleDeg + THREE_SIXTY_DEG ) : angleDeg;
+}
+
 double TriangleOfVelocitiesSolver::invertAngle( double angleDeg ) const
 {
     angleDeg += ONE_EIGHTY_DEG;
@@ -2,26 +2,30 @@
 #define __TRIANGLE_H__
 
 #include <assert.h>
-#include <GLFW/glfw3.h>
+#include <cstddef>
+#include <cstdint>
 
 // Math
 #include "mathUtils.h"
 #include "quat.h"
+#include "fastTrig.h"
 
 using namespace GrapheneMath;
 
-struct TriangleOfVelocities
+// Fields of one triangle in the precision of Scalar (float, double or long double).
+template <typename Scalar>
+struct BasicTriangleOfVelocities
 {
     // directions in DEG T
     // speeds in kts
-    double  TR;  //< track (DEG T)
-    double  TAS; //< true airspeed (kts)
-    double  W;   //< wind direction (DEG T, direction FROM the wind is blowing)
-    double  V;   //< wind speed (kts)
-    double  HDG; //< heading (DEG T)
-    double  GS;  //< ground speed (kts)
-
-    TriangleOfVelocities()
+    Scalar  TR;  //< track (DEG T)
+    Scalar  TAS; //< true airspeed (kts)
+    Scalar  W;   //< wind direction (DEG T, direction FROM the wind is blowing)
+    Scalar  V;   //< wind speed (kts)
+    Scalar  HDG; //< heading (DEG T)
+    Scalar  GS;  //< ground speed (kts)
+
+    BasicTriangleOfVelocities()
         : TR ( 0.0f )
         , TAS( 0.0f )
         , W  ( 0.0f )
@@ -31,11 +35,95 @@ struct TriangleOfVelocities
     {}
 };
 
+typedef BasicTriangleOfVelocities<double> TriangleOfVelocities;
+
+// Structure-of-arrays view over many triangles, e.g. every leg of a flight plan.
+// Fields and units are the same as in TriangleOfVelocities.
+// The known fields (solver mask) are read, the remaining two are written, so
+// which pointers are inputs depends on the mask (solveMasked() writes TR, TAS,
+// W or V too). Every array has to be set, hold at least 'count' elements and
+// not overlap another one.
+template <typename Scalar>
+struct BasicTriangleOfVelocitiesSoA
+{
+    Scalar* TR;
+    Scalar* TAS;
+    Scalar* W;
+    Scalar* V;
+    Scalar* HDG;
+    Scalar* GS;
+    size_t  count;
+
+    BasicTriangleOfVelocitiesSoA()
+        : TR ( NULL )
+        , TAS( NULL )
+        , W  ( NULL )
+        , V  ( NULL )
+        , HDG( NULL )
+        , GS ( NULL )
+        , count( 0 )
+    {}
+};
+
+typedef BasicTriangleOfVelocitiesSoA<double> TriangleOfVelocitiesSoA;
+
+// Result of TriangleOfVelocitiesSolver::solveSilent().
+// Classification follows Bronsztejn: with TAS >= V there is a single solution,
+// with TAS < V there are either two headings giving the same track, a single
+// tangent one (<)HDG,GS = 90 DEG) or none at all.
+struct TriangleSolution
+{
+    enum Type : uint8_t
+    {
+        eSingle = 0,
+        eTwo,
+        eTangent,
+        eImpossible,
+        eNumTypes
+    };
+
+    Type     type;
+    uint8_t  numSolutions; //< valid entries in HDG and GS
+    double   HDG[ 2 ];     //< heading (DEG T), [0] is the faster solution
+    double   GS[ 2 ];      //< ground speed (kts)
+
+    TriangleSolution()
+        : type( eImpossible )
+        , numSolutions( 0 )
+    {
+        HDG[0] = HDG[1] = 0.0;
+        GS[0]  = GS[1]  = 0.0;
+    }
+};
+
+// Opt-in diagnostics for solveSilent(): number of solved triangles per solution type.
+struct TriangleSolverStats
+{
+    uint64_t count[ TriangleSolution::eNumTypes ];
+
+    TriangleSolverStats() { Reset(); }
+
+    void Reset()
+    {
+        for( int i = 0; i < TriangleSolution::eNumTypes; ++i ) {
+            count[i] = 0;
+        }
+    }
+};
+
+// Opt-in diagnostics for solveSilent(): called once per solved triangle.
+typedef void (*TriangleSolverCallback)( const TriangleOfVelocities& tov,
+                                        const TriangleSolution&     solution,
+                                        void*                       userData );
+
 class TriangleOfVelocitiesSolver
 {
   public:
-    static const double THREE_SIXTY_DEG;
-    static const double ONE_EIGHTY_DEG;
+    static constexpr double THREE_SIXTY_DEG = 360.0;
+    static constexpr double ONE_EIGHTY_DEG  = 180.0;
+    static constexpr double DEG_TO_RAD      = static_cast<double>( PI_OVER_ONE_EIGHTY_L );
+    static constexpr double RAD_TO_DEG      = static_cast<double>( ONE_EIGHTY_OVER_PI_L );
+    static const double SOLUTION_TOLERANCE;
 
     enum DataFields : uint8_t
     {
@@ -52,19 +140,345 @@ class TriangleOfVelocitiesSolver
                                                       //< vector (W/V), dir(TR), length(TAS)
     uint8_t m_mask;
 
+    // Every mask of known fields the solver has a kernel for.
+    // Any other combination of four fields is either ambiguous or degenerate.
+    enum SolvableMask : uint8_t
+    {
+        eFindHdgGs  = eW   | eV   | eTR  | eTAS, //< W/V + TR + TAS   -> HDG/GS (most common)
+        eFindWind   = eHDG | eTAS | eTR  | eGS,  //< HDG/TAS + TR/GS  -> W/V (wind finding)
+        eFindTrGs   = eHDG | eTAS | eW   | eV,   //< HDG/TAS + W/V    -> TR/GS (dead reckoning)
+        eFindHdgTas = eW   | eV   | eTR  | eGS,  //< W/V + TR/GS      -> HDG/TAS
+        eFindTasGs  = eW   | eV   | eHDG | eTR,  //< W/V + HDG + TR   -> TAS/GS
+        eFindTrTas  = eW   | eV   | eHDG | eGS   //< W/V + HDG + GS   -> TR/TAS
+    };
+
 public:
 
     TriangleOfVelocitiesSolver();
 
     void solve( TriangleOfVelocities& triangle );
+
+    // Batch solver W/V + TR + TAS -> HDG/GS for a whole flight plan, two
+    // triangles per SSE step (solveBatch< eFindHdgGs >, eTrig1e6 polynomials).
+    // HDG is returned in range [0, 360). Where solve() has a well defined answer
+    // both agree to within 1e-4 DEG and 3e-4 kts for V < 0.9 TAS (triangleBench),
+    // less close to the tangent V sin( W - TR ) = TAS. Also solve() reports |HDG|
+    // instead of wrapping when the corrected heading crosses North, and GS = 0
+    // in calm wind.
+    void solve( const TriangleOfVelocitiesSoA& batch ) const;
+
+    // W/V + TR + TAS -> HDG/GS without console I/O and without asserts.
+    // Returns every valid solution together with its classification.
+    // The input triangle is not modified.
+    const TriangleSolution solveSilent( const TriangleOfVelocities& tov ) const;
+
+    // Diagnostics are off by default. Pass NULL to switch them off again.
+    void setStats( TriangleSolverStats* stats ) { m_stats = stats; }
+    void setCallback( TriangleSolverCallback callback, void* userData )
+    {
+        m_callback     = callback;
+        m_callbackData = userData;
+    }
+
+    // Alternative W/V + TR + TAS -> HDG/GS formulations, silent, HDG in [0, 360).
+    // Kept for comparison with the kernels (see triangleBench.cxx).
+    void solveVecDirLength( TriangleOfVelocities& tov ) const;  //< law of cosines (quadratic in GS)
+    void solveVecDirLength2( TriangleOfVelocities& tov ) const; //< generic sine rule
+    void solveVectorAlgebra( TriangleOfVelocities& tov ) const; //< Vector3/Quaternion reference
+
+    static bool isSolvable( uint8_t mask );
+
+    // Solve for the fields missing from m_mask. Returns false, leaving the
+    // triangle untouched, if m_mask is not one of SolvableMask.
+    bool solveMasked( TriangleOfVelocities& tov ) const;
+
+    // Batch version of solveMasked(). The mask is dispatched once per batch,
+    // the kernels keep the GRAPHENE_FAST_TRIG trigonometry of the scalar path.
+    bool solveMasked( const TriangleOfVelocitiesSoA& batch ) const;
+
+    // Batch solver for a mask fixed at compile time, no dispatch at all.
+    // Runs in the precision of the batch with the trigonometry of Accuracy
+    // (fastTrig.h). eFindHdgGs with a polynomial accuracy runs on SSE lanes
+    // (TriangleLanes), four floats or two doubles per step; other masks, long
+    // double and eTrigLibm loop over the scalar kernel.
+    template <uint8_t Mask, int Accuracy = eTrig1e6, typename Scalar>
+    static void solveBatch( const BasicTriangleOfVelocitiesSoA<Scalar>& batch );
+
     double invertWind( double windFromDeg );
     double invertAngle( double angleDeg ) const;
     
 private:
-    void solveVecDirLength();
-    void solveVecDirLength2();
+    TriangleSolverStats*   m_stats;
+    TriangleSolverCallback m_callback;
+    void*                  m_callbackData;
+
+    double wrapAngle( double angleDeg ) const;
     bool isSane( const TriangleOfVelocities& tov );
 
 };
 
+// Helpers shared by the triangle kernels, all branch free.
+// North is the x axis, East the z axis, directions in DEG T measured clockwise.
+// Every helper and kernel runs in the precision of its arguments, constants
+// are rounded to it at compile time.
+struct TriangleKernelBase
+{
+    typedef TriangleOfVelocitiesSolver Solver;
+
+    // Wraps an angle from range [-360, 720) into [0, 360).
+    template <typename Scalar>
+    static inline Scalar wrap360( Scalar angleDeg )
+    {
+        const Scalar THREE_SIXTY = static_cast<Scalar>( Solver::THREE_SIXTY_DEG );
+        angleDeg = ( angleDeg < Scalar( 0.0 ) ) ? ( angleDeg + THREE_SIXTY ) : angleDeg;
+        return ( angleDeg >= THREE_SIXTY ) ? ( angleDeg - THREE_SIXTY ) : angleDeg;
+    }
+
+    // Direction (DEG T) of a vector given by its North and East components.
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    static inline Scalar direction( Scalar north, Scalar east )
+    {
+        return wrap360( Trig<Scalar, Accuracy>::Atan2( east, north ) * Constants<Scalar>::RadToDeg() );
+    }
+};
+
+// Kernel solving one triangle for the fields missing from Mask, with the
+// trigonometry of Accuracy (the GRAPHENE_FAST_TRIG policy by default).
+// Only masks listed in TriangleOfVelocitiesSolver::SolvableMask are specialised,
+// any other mask fails to compile.
+template <uint8_t Mask>
+struct TriangleKernel;
+
+// W/V + TR + TAS -> HDG/GS, wind-relative sine rule.
+// WCA = asin( V * sin( W - TR ) / TAS ), HDG = TR + WCA,
+// GS  = TAS * cos( WCA ) - V * cos( W - TR ).
+template <>
+struct TriangleKernel< TriangleOfVelocitiesSolver::eFindHdgGs > : TriangleKernelBase
+{
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    static inline void solve( Scalar& TR, Scalar& TAS, Scalar& W, Scalar& V, Scalar& HDG, Scalar& GS )
+    {
+        const Scalar TR_RAD  = TR * Constants<Scalar>::DegToRad();
+        const Scalar relWind = W * Constants<Scalar>::DegToRad() - TR_RAD; //< <)W,TR (wind FROM)
+
+        Scalar sinWCA = ( V * Trig<Scalar, Accuracy>::Sin( relWind ) ) / TAS;
+        sinWCA = ( sinWCA > Scalar( 1.0 ) ) ? Scalar( 1.0 ) : sinWCA;
+        sinWCA = ( sinWCA < Scalar( -1.0 ) ) ? Scalar( -1.0 ) : sinWCA;
+
+        HDG = wrap360( ( TR_RAD + Trig<Scalar, Accuracy>::Asin( sinWCA ) ) * Constants<Scalar>::RadToDeg() );
+        GS  = TAS * sqrt( Scalar( 1.0 ) - sinWCA * sinWCA ) - V * Trig<Scalar, Accuracy>::Cos( relWind );
+    }
+};
+
+// HDG/TAS + TR/GS -> W/V, wind = ground vector - air vector.
+template <>
+struct TriangleKernel< TriangleOfVelocitiesSolver::eFindWind > : TriangleKernelBase
+{
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    static inline void solve( Scalar& TR, Scalar& TAS, Scalar& W, Scalar& V, Scalar& HDG, Scalar& GS )
+    {
+        const Scalar TR_RAD  = TR * Constants<Scalar>::DegToRad();
+        const Scalar HDG_RAD = HDG * Constants<Scalar>::DegToRad();
+        const Scalar north   = GS * Trig<Scalar, Accuracy>::Cos( TR_RAD ) - TAS * Trig<Scalar, Accuracy>::Cos( HDG_RAD );
+        const Scalar east    = GS * Trig<Scalar, Accuracy>::Sin( TR_RAD ) - TAS * Trig<Scalar, Accuracy>::Sin( HDG_RAD );
+
+        V = sqrt( north * north + east * east );
+        W = direction<Scalar, Accuracy>( -north, -east ); //< direction FROM
+    }
+};
+
+// HDG/TAS + W/V -> TR/GS, ground vector = air vector + wind.
+template <>
+struct TriangleKernel< TriangleOfVelocitiesSolver::eFindTrGs > : TriangleKernelBase
+{
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    static inline void solve( Scalar& TR, Scalar& TAS, Scalar& W, Scalar& V, Scalar& HDG, Scalar& GS )
+    {
+        const Scalar HDG_RAD = HDG * Constants<Scalar>::DegToRad();
+        const Scalar W_RAD   = W * Constants<Scalar>::DegToRad();
+        const Scalar north   = TAS * Trig<Scalar, Accuracy>::Cos( HDG_RAD ) - V * Trig<Scalar, Accuracy>::Cos( W_RAD );
+        const Scalar east    = TAS * Trig<Scalar, Accuracy>::Sin( HDG_RAD ) - V * Trig<Scalar, Accuracy>::Sin( W_RAD );
+
+        GS = sqrt( north * north + east * east );
+        TR = direction<Scalar, Accuracy>( north, east );
+    }
+};
+
+// W/V + TR/GS -> HDG/TAS, air vector = ground vector - wind.
+template <>
+struct TriangleKernel< TriangleOfVelocitiesSolver::eFindHdgTas > : TriangleKernelBase
+{
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    static inline void solve( Scalar& TR, Scalar& TAS, Scalar& W, Scalar& V, Scalar& HDG, Scalar& GS )
+    {
+        const Scalar TR_RAD = TR * Constants<Scalar>::DegToRad();
+        const Scalar W_RAD  = W * Constants<Scalar>::DegToRad();
+        const Scalar north  = GS * Trig<Scalar, Accuracy>::Cos( TR_RAD ) + V * Trig<Scalar, Accuracy>::Cos( W_RAD );
+        const Scalar east   = GS * Trig<Scalar, Accuracy>::Sin( TR_RAD ) + V * Trig<Scalar, Accuracy>::Sin( W_RAD );
+
+        TAS = sqrt( north * north + east * east );
+        HDG = direction<Scalar, Accuracy>( north, east );
+    }
+};
+
+// W/V + HDG + TR -> TAS/GS, generic sine rule with W as direction FROM:
+//
+//        V                TAS                GS
+// ---------------  = -------------  = --------------
+// sin( HDG - TR )    sin( W - TR )    sin( W - HDG )
+//
+// Undefined when HDG == TR (no drift, any TAS fits).
+template <>
+struct TriangleKernel< TriangleOfVelocitiesSolver::eFindTasGs > : TriangleKernelBase
+{
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    static inline void solve( Scalar& TR, Scalar& TAS, Scalar& W, Scalar& V, Scalar& HDG, Scalar& GS )
+    {
+        const Scalar TR_RAD  = TR * Constants<Scalar>::DegToRad();
+        const Scalar HDG_RAD = HDG * Constants<Scalar>::DegToRad();
+        const Scalar W_RAD   = W * Constants<Scalar>::DegToRad();
+        const Scalar ratio   = V / Trig<Scalar, Accuracy>::Sin( HDG_RAD - TR_RAD );
+
+        TAS = ratio * Trig<Scalar, Accuracy>::Sin( W_RAD - TR_RAD );
+        GS  = ratio * Trig<Scalar, Accuracy>::Sin( W_RAD - HDG_RAD );
+    }
+};
+
+// W/V + HDG + GS -> TR/TAS, law of cosines:
+// GS2 = TAS2 + V2 - 2 TAS V cos( HDG - W ), larger root for TAS.
+// The discriminant is clamped to 0 when GS is too small for this wind.
+template <>
+struct TriangleKernel< TriangleOfVelocitiesSolver::eFindTrTas > : TriangleKernelBase
+{
+    template <typename Scalar, int Accuracy = GRAPHENE_FAST_TRIG>
+    static inline void solve( Scalar& TR, Scalar& TAS, Scalar& W, Scalar& V, Scalar& HDG, Scalar& GS )
+    {
+        const Scalar HDG_RAD = HDG * Constants<Scalar>::DegToRad();
+        const Scalar W_RAD   = W * Constants<Scalar>::DegToRad();
+        const Scalar cosHW   = Trig<Scalar, Accuracy>::Cos( HDG_RAD - W_RAD );
+        const Scalar VcosHW  = V * cosHW;
+
+        Scalar delta = VcosHW * VcosHW - V * V + GS * GS;
+        delta = ( delta < Scalar( 0.0 ) ) ? Scalar( 0.0 ) : delta;
+        TAS = VcosHW + sqrt( delta );
+
+        const Scalar north = TAS * Trig<Scalar, Accuracy>::Cos( HDG_RAD ) - V * Trig<Scalar, Accuracy>::Cos( W_RAD );
+        const Scalar east  = TAS * Trig<Scalar, Accuracy>::Sin( HDG_RAD ) - V * Trig<Scalar, Accuracy>::Sin( W_RAD );
+        TR = direction<Scalar, Accuracy>( north, east );
+    }
+};
+
+// No lanes, every triangle of the batch goes through the scalar kernel.
+struct TriangleNoLanes
+{
+    template <typename Scalar>
+    static inline size_t solve( const Scalar*, const Scalar*, const Scalar*, const Scalar*, Scalar*, Scalar*, size_t )
+    {
+        return 0;
+    }
+};
+
+// SSE version of TriangleKernel< Mask > over the front of a batch: solve()
+// returns how many triangles it solved, the rest go through the scalar kernel.
+// Only specialised masks and precisions have lanes.
+template <uint8_t Mask, int Accuracy>
+struct TriangleLanes : TriangleNoLanes
+{
+};
+
+#if GRAPHENE_SIMD
+// W/V + TR + TAS -> HDG/GS, the formula of TriangleKernel< eFindHdgGs > with
+// TrigLanes. The clamp of sin( WCA ) and wrap360 become min/max and masks.
+template <int Accuracy>
+struct TriangleLanes< TriangleOfVelocitiesSolver::eFindHdgGs, Accuracy > : TriangleNoLanes
+{
+    using TriangleNoLanes::solve; //< long double
+
+    static inline size_t solve( const float* __restrict TR, const float* __restrict TAS, const float* __restrict W, const float* __restrict V,
+                                float* __restrict HDG, float* __restrict GS, size_t count )
+    {
+        typedef TrigLanes<Accuracy> Lanes;
+        const __m128 degToRad   = _mm_set1_ps( Constants<float>::DegToRad() );
+        const __m128 radToDeg   = _mm_set1_ps( Constants<float>::RadToDeg() );
+        const __m128 one        = _mm_set1_ps( 1.0f );
+        const __m128 threeSixty = _mm_set1_ps( static_cast<float>( TriangleOfVelocitiesSolver::THREE_SIXTY_DEG ) );
+
+        const size_t end = count & ~size_t( 3 );
+        for( size_t i = 0; i < end; i += 4 )
+        {
+            const __m128 tas     = _mm_loadu_ps( TAS + i );
+            const __m128 v       = _mm_loadu_ps( V + i );
+            const __m128 TR_RAD  = _mm_mul_ps( _mm_loadu_ps( TR + i ), degToRad );
+            const __m128 relWind = _mm_sub_ps( _mm_mul_ps( _mm_loadu_ps( W + i ), degToRad ), TR_RAD );
+
+            __m128 sinWCA = _mm_div_ps( _mm_mul_ps( v, Lanes::Sin( relWind ) ), tas );
+            sinWCA = _mm_max_ps( _mm_min_ps( sinWCA, one ), _mm_set1_ps( -1.0f ) );
+            const __m128 cosWCA = _mm_sqrt_ps( _mm_mul_ps( _mm_sub_ps( one, sinWCA ), _mm_add_ps( one, sinWCA ) ) );
+
+            __m128 hdg = _mm_mul_ps( _mm_add_ps( TR_RAD, Lanes::Atan2( sinWCA, cosWCA ) ), radToDeg );
+            hdg = _mm_add_ps( hdg, _mm_and_ps( _mm_cmplt_ps( hdg, _mm_setzero_ps() ), threeSixty ) );
+            hdg = _mm_sub_ps( hdg, _mm_and_ps( _mm_cmpge_ps( hdg, threeSixty ), threeSixty ) );
+
+            _mm_storeu_ps( HDG + i, hdg );
+            _mm_storeu_ps( GS + i, _mm_sub_ps( _mm_mul_ps( tas, cosWCA ), _mm_mul_ps( v, Lanes::Cos( relWind ) ) ) );
+        }
+        return end;
+    }
+
+    static inline size_t solve( const double* __restrict TR, const double* __restrict TAS, const double* __restrict W, const double* __restrict V,
+                                double* __restrict HDG, double* __restrict GS, size_t count )
+    {
+        typedef TrigLanesDouble<Accuracy> Lanes;
+        const __m128d degToRad   = _mm_set1_pd( Constants<double>::DegToRad() );
+        const __m128d radToDeg   = _mm_set1_pd( Constants<double>::RadToDeg() );
+        const __m128d one        = _mm_set1_pd( 1.0 );
+        const __m128d threeSixty = _mm_set1_pd( TriangleOfVelocitiesSolver::THREE_SIXTY_DEG );
+
+        const size_t end = count & ~size_t( 1 );
+        for( size_t i = 0; i < end; i += 2 )
+        {
+            const __m128d tas     = _mm_loadu_pd( TAS + i );
+            const __m128d v       = _mm_loadu_pd( V + i );
+            const __m128d TR_RAD  = _mm_mul_pd( _mm_loadu_pd( TR + i ), degToRad );
+            const __m128d relWind = _mm_sub_pd( _mm_mul_pd( _mm_loadu_pd( W + i ), degToRad ), TR_RAD );
+
+            __m128d sinWCA = _mm_div_pd( _mm_mul_pd( v, Lanes::Sin( relWind ) ), tas );
+            sinWCA = _mm_max_pd( _mm_min_pd( sinWCA, one ), _mm_set1_pd( -1.0 ) );
+            const __m128d cosWCA = _mm_sqrt_pd( _mm_mul_pd( _mm_sub_pd( one, sinWCA ), _mm_add_pd( one, sinWCA ) ) );
+
+            __m128d hdg = _mm_mul_pd( _mm_add_pd( TR_RAD, Lanes::Atan2( sinWCA, cosWCA ) ), radToDeg );
+            hdg = _mm_add_pd( hdg, _mm_and_pd( _mm_cmplt_pd( hdg, _mm_setzero_pd() ), threeSixty ) );
+            hdg = _mm_sub_pd( hdg, _mm_and_pd( _mm_cmpge_pd( hdg, threeSixty ), threeSixty ) );
+
+            _mm_storeu_pd( HDG + i, hdg );
+            _mm_storeu_pd( GS + i, _mm_sub_pd( _mm_mul_pd( tas, cosWCA ), _mm_mul_pd( v, Lanes::Cos( relWind ) ) ) );
+        }
+        return end;
+    }
+};
+
+// The C library has no lanes.
+template <>
+struct TriangleLanes< TriangleOfVelocitiesSolver::eFindHdgGs, eTrigLibm > : TriangleNoLanes
+{
+};
+#endif // GRAPHENE_SIMD
+
+template <uint8_t Mask, int Accuracy, typename Scalar>
+void TriangleOfVelocitiesSolver::solveBatch( const BasicTriangleOfVelocitiesSoA<Scalar>& batch )
+{
+    Scalar* __restrict const TR  = batch.TR;
+    Scalar* __restrict const TAS = batch.TAS;
+    Scalar* __restrict const W   = batch.W;
+    Scalar* __restrict const V   = batch.V;
+    Scalar* __restrict const HDG = batch.HDG;
+    Scalar* __restrict const GS  = batch.GS;
+
+    size_t i = TriangleLanes< Mask, Accuracy >::solve( TR, TAS, W, V, HDG, GS, batch.count );
+    for( ; i < batch.count; ++i )
+    {
+        TriangleKernel< Mask >::template solve< Scalar, Accuracy >( TR[i], TAS[i], W[i], V[i], HDG[i], GS[i] );
+    }
+}
+
 #endif //__TRIANGLE_H__
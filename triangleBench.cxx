@@ -0,0 +1,539 @@
+// Triangle of velocities: speed and accuracy of every W/V + TR + TAS -> HDG/GS
+// formulation on the same randomised inputs. Build and run with 'make bench'.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "triangle.h"
+#include "windCorrectionTable.h"
+#include "windEstimator.h"
+
+using namespace GrapheneMath;
+
+// Randomised triangles with a known answer.
+// HDG/TAS and W/V are drawn at random and TR/GS are computed forward from the
+// vector sum in long double, so every formulation is compared against the same
+// exact solution. TAS > V keeps the solution unique.
+struct BenchInputs
+{
+    std::vector<TriangleOfVelocities> triangles; //< TR, TAS, W, V set, HDG and GS exact
+
+    explicit BenchInputs( size_t count )
+    {
+        std::mt19937 rng( 2024 );
+        std::uniform_real_distribution<double> dir( 0.0, 360.0 );
+        std::uniform_real_distribution<double> tas( 60.0, 200.0 );
+        std::uniform_real_distribution<double> windRatio( 0.0, 0.9 );
+
+        const long double degToRad = PI_OVER_ONE_EIGHTY_L;
+
+        triangles.resize( count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            TriangleOfVelocities& tov = triangles[i];
+            tov.HDG = dir( rng );
+            tov.TAS = tas( rng );
+            tov.W   = dir( rng );
+            tov.V   = tov.TAS * windRatio( rng );
+
+            // Ground vector = air vector + wind (TO), North x, East z.
+            const long double north = tov.TAS * cosl( tov.HDG * degToRad ) - tov.V * cosl( tov.W * degToRad );
+            const long double east  = tov.TAS * sinl( tov.HDG * degToRad ) - tov.V * sinl( tov.W * degToRad );
+            const long double TR    = atan2l( east, north ) / degToRad;
+
+            tov.GS = static_cast<double>( sqrtl( north * north + east * east ) );
+            tov.TR = static_cast<double>( ( TR < 0.0L ) ? TR + 360.0L : TR );
+        }
+    }
+};
+
+struct BenchResult
+{
+    double nsPerOp;
+    double maxErrorHDG; //< DEG
+    double rmsErrorHDG;
+    double maxErrorGS;  //< kts
+    double rmsErrorGS;
+};
+
+// Discards everything written to it, mutes the console output of solve().
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow( int c ) { return c; }
+};
+
+static double AngleError( double a, double b )
+{
+    const double d = fabs( a - b );
+    return ( d > 180.0 ) ? ( 360.0 - d ) : d;
+}
+
+static void CollectErrors( const BenchInputs& inputs, const std::vector<double>& HDG, const std::vector<double>& GS, BenchResult& result )
+{
+    double sumSqHDG = 0.0;
+    double sumSqGS  = 0.0;
+    result.maxErrorHDG = 0.0;
+    result.maxErrorGS  = 0.0;
+
+    const size_t count = inputs.triangles.size();
+    for( size_t i = 0; i < count; ++i )
+    {
+        // NaN must not hide as a small error.
+        const double errHDG = AngleError( HDG[i], inputs.triangles[i].HDG );
+        const double errGS  = fabs( GS[i] - inputs.triangles[i].GS );
+        result.maxErrorHDG = ( errHDG == errHDG ) ? std::max( result.maxErrorHDG, errHDG ) : HUGE_VAL;
+        result.maxErrorGS  = ( errGS == errGS ) ? std::max( result.maxErrorGS, errGS ) : HUGE_VAL;
+        sumSqHDG += errHDG * errHDG;
+        sumSqGS  += errGS * errGS;
+    }
+
+    result.rmsErrorHDG = sqrt( sumSqHDG / count );
+    result.rmsErrorGS  = sqrt( sumSqGS / count );
+}
+
+// Times one triangle at a time through 'solve'.
+template <typename SolveFn>
+static BenchResult RunScalar( const BenchInputs& inputs, unsigned reps, SolveFn solve )
+{
+    const size_t count = inputs.triangles.size();
+    std::vector<TriangleOfVelocities> work( inputs.triangles );
+    std::vector<double> HDG( count ), GS( count );
+
+    Benchmark::Timer timer;
+    for( unsigned r = 0; r < reps; ++r )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            solve( work[i] );
+            Benchmark::DoNotOptimize( work[i] );
+        }
+        Benchmark::ClobberMemory();
+    }
+
+    BenchResult result;
+    result.nsPerOp = timer.ElapsedNs() / ( static_cast<double>( reps ) * count );
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        HDG[i] = work[i].HDG;
+        GS[i]  = work[i].GS;
+    }
+
+    CollectErrors( inputs, HDG, GS, result );
+    return result;
+}
+
+// Times the structure-of-arrays batch solver.
+static BenchResult RunBatch( const BenchInputs& inputs, unsigned reps )
+{
+    const size_t count = inputs.triangles.size();
+    std::vector<double> TR( count ), TAS( count ), W( count ), V( count ), HDG( count ), GS( count );
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        TR[i]  = inputs.triangles[i].TR;
+        TAS[i] = inputs.triangles[i].TAS;
+        W[i]   = inputs.triangles[i].W;
+        V[i]   = inputs.triangles[i].V;
+    }
+
+    TriangleOfVelocitiesSoA batch;
+    batch.TR    = &TR[0];
+    batch.TAS   = &TAS[0];
+    batch.W     = &W[0];
+    batch.V     = &V[0];
+    batch.HDG   = &HDG[0];
+    batch.GS    = &GS[0];
+    batch.count = count;
+
+    const TriangleOfVelocitiesSolver solver;
+
+    Benchmark::Timer timer;
+    for( unsigned r = 0; r < reps; ++r )
+    {
+        solver.solve( batch );
+        Benchmark::ClobberMemory();
+    }
+
+    BenchResult result;
+    result.nsPerOp = timer.ElapsedNs() / ( static_cast<double>( reps ) * count );
+    CollectErrors( inputs, HDG, GS, result );
+    return result;
+}
+
+// Times the batch solver in the precision of Scalar with the trigonometry of
+// Accuracy, errors against the exact solution.
+template <typename Scalar, int Accuracy>
+static BenchResult RunBatchPrecision( const BenchInputs& inputs, unsigned reps )
+{
+    const size_t count = inputs.triangles.size();
+    std::vector<Scalar> TR( count ), TAS( count ), W( count ), V( count ), HDG( count ), GS( count );
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        TR[i]  = static_cast<Scalar>( inputs.triangles[i].TR );
+        TAS[i] = static_cast<Scalar>( inputs.triangles[i].TAS );
+        W[i]   = static_cast<Scalar>( inputs.triangles[i].W );
+        V[i]   = static_cast<Scalar>( inputs.triangles[i].V );
+    }
+
+    BasicTriangleOfVelocitiesSoA<Scalar> batch;
+    batch.TR    = &TR[0];
+    batch.TAS   = &TAS[0];
+    batch.W     = &W[0];
+    batch.V     = &V[0];
+    batch.HDG   = &HDG[0];
+    batch.GS    = &GS[0];
+    batch.count = count;
+
+    Benchmark::Timer timer;
+    for( unsigned r = 0; r < reps; ++r )
+    {
+        TriangleOfVelocitiesSolver::solveBatch< TriangleOfVelocitiesSolver::eFindHdgGs, Accuracy >( batch );
+        Benchmark::ClobberMemory();
+    }
+
+    BenchResult result;
+    result.nsPerOp = timer.ElapsedNs() / ( static_cast<double>( reps ) * count );
+
+    const std::vector<double> HDGd( HDG.begin(), HDG.end() );
+    const std::vector<double> GSd( GS.begin(), GS.end() );
+    CollectErrors( inputs, HDGd, GSd, result );
+    return result;
+}
+
+// Times turning North to every HDG with a quaternion in the precision of Scalar.
+// Errors are the distance from the long double result, reported in the HDG columns.
+template <typename Scalar>
+static BenchResult RunRotatePrecision( const BenchInputs& inputs, unsigned reps )
+{
+    const size_t count = inputs.triangles.size();
+    const Vector3<Scalar> north( Scalar( 1.0 ), Scalar( 0.0 ), Scalar( 0.0 ) );
+    const Vector3<Scalar> down( Scalar( 0.0 ), Scalar( -1.0 ), Scalar( 0.0 ) );
+    std::vector< Vector3<Scalar> > rotated( count );
+
+    Benchmark::Timer timer;
+    for( unsigned r = 0; r < reps; ++r )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            Quaternion<Scalar> rot;
+            rot.FromAxisAngle( down, Deg2Rad( static_cast<Scalar>( inputs.triangles[i].HDG ) ) );
+            rotated[i] = rot.RotateFast( north );
+        }
+        Benchmark::ClobberMemory();
+    }
+
+    BenchResult result;
+    result.nsPerOp     = timer.ElapsedNs() / ( static_cast<double>( reps ) * count );
+    result.maxErrorHDG = 0.0;
+    result.maxErrorGS  = 0.0;
+    result.rmsErrorGS  = 0.0;
+
+    const Vector3<long double> northRef( 1.0L, 0.0L, 0.0L );
+    const Vector3<long double> downRef( 0.0L, -1.0L, 0.0L );
+    long double sumSq = 0.0L;
+    for( size_t i = 0; i < count; ++i )
+    {
+        Quaternion<long double> rot;
+        rot.FromAxisAngle( downRef, Deg2Rad( static_cast<long double>( inputs.triangles[i].HDG ) ) );
+        const Vector3<long double> exact = rot.RotateFast( northRef );
+        const Vector3<long double> error( rotated[i].GetX() - exact.GetX(),
+                                          rotated[i].GetY() - exact.GetY(),
+                                          rotated[i].GetZ() - exact.GetZ() );
+        const double err = static_cast<double>( error.Mag() );
+        result.maxErrorHDG = std::max( result.maxErrorHDG, err );
+        sumSq += err * err;
+    }
+    result.rmsErrorHDG = static_cast<double>( sqrtl( sumSq / count ) );
+    return result;
+}
+
+// Replays fixes of a constant wind through the estimator, with 'noiseKt' of
+// normally distributed error on GS and the same in knots on the TR. Timed over
+// 'reps' passes, the estimate and its standard error are of one pass.
+static void RunWindEstimator( const char* name, size_t count, unsigned reps, double noiseKt )
+{
+    const double W = 240.0;
+    const double V = 35.0;
+
+    std::mt19937 rng( 7 );
+    std::uniform_real_distribution<double> dir( 0.0, 360.0 );
+    std::uniform_real_distribution<double> tas( 60.0, 200.0 );
+    std::normal_distribution<double> noise( 0.0, 1.0 );
+
+    std::vector<double> TR( count ), TAS( count ), WW( count, W ), VV( count, V ), HDG( count ), GS( count );
+    for( size_t i = 0; i < count; ++i )
+    {
+        HDG[i] = dir( rng );
+        TAS[i] = tas( rng );
+    }
+
+    TriangleOfVelocitiesSoA batch;
+    batch.TR    = &TR[0];
+    batch.TAS   = &TAS[0];
+    batch.W     = &WW[0];
+    batch.V     = &VV[0];
+    batch.HDG   = &HDG[0];
+    batch.GS    = &GS[0];
+    batch.count = count;
+    TriangleOfVelocitiesSolver::solveBatch< TriangleOfVelocitiesSolver::eFindTrGs, GRAPHENE_FAST_TRIG >( batch );
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        GS[i] += noiseKt * noise( rng );
+        TR[i] += Rad2Deg( noiseKt * noise( rng ) / GS[i] );
+    }
+
+    // Replaying the fixes only times AddSamples(), the same fixes again would
+    // understate the standard error by sqrt( reps ).
+    WindEstimator replay;
+    Benchmark::Timer timer;
+    for( unsigned r = 0; r < reps; ++r )
+    {
+        replay.AddSamples( batch );
+    }
+    const double nsPerSample = timer.ElapsedNs() / ( static_cast<double>( reps ) * count );
+    Benchmark::DoNotOptimize( replay.GetNumSamples() );
+
+    // Estimate and confidence from a single pass over the fixes.
+    WindEstimator estimator;
+    estimator.AddSamples( batch );
+
+    double estW = 0.0;
+    double estV = 0.0;
+    estimator.GetWind( estW, estV );
+    printf( "%-34s %9.2f %10.2f   W %7.3f V %7.3f  scatter %6.3f kts  std error %8.2e kts\n",
+            name, nsPerSample, 1000.0 / nsPerSample, estW, estV,
+            estimator.GetScatterKt(), estimator.GetStdErrorKt() );
+}
+
+static void Print( const char* name, const BenchResult& result )
+{
+    printf( "%-34s %9.2f %10.2f %12.3e %12.3e %12.3e %12.3e\n",
+            name,
+            result.nsPerOp,
+            1000.0 / result.nsPerOp,
+            result.maxErrorHDG, result.rmsErrorHDG,
+            result.maxErrorGS, result.rmsErrorGS );
+}
+
+// Hand-worked reference triangles ("Test 01" and "Test 02" in triangle.cxx),
+// answers worked on a flight computer to about 1 DEG and 1 kt.
+struct ReferenceCase
+{
+    double TR, TAS, W, V, HDG, GS;
+};
+
+static const ReferenceCase c_referenceCases[] =
+{
+    //  TR     TAS    W      V     HDG    GS
+    { 150.0, 100.0,   0.0, 30.0, 141.0, 125.0 },
+    { 290.0, 174.0, 240.0, 40.0, 280.0, 145.0 }
+};
+
+// Checks a formulation against the reference triangles, within 1 DEG and 1 kt.
+template <typename SolveFn>
+static bool CheckReference( const char* name, SolveFn solve )
+{
+    bool passed = true;
+    printf( "%-34s", name );
+    for( size_t i = 0; i < sizeof( c_referenceCases ) / sizeof( c_referenceCases[0] ); ++i )
+    {
+        TriangleOfVelocities tov;
+        tov.TR  = c_referenceCases[i].TR;
+        tov.TAS = c_referenceCases[i].TAS;
+        tov.W   = c_referenceCases[i].W;
+        tov.V   = c_referenceCases[i].V;
+        solve( tov );
+
+        const bool ok = ( AngleError( tov.HDG, c_referenceCases[i].HDG ) <= 1.0 ) &&
+                        ( fabs( tov.GS - c_referenceCases[i].GS ) <= 1.0 );
+        printf( "  HDG %7.3f GS %7.3f %s", tov.HDG, tov.GS, ok ? "ok  " : "FAIL" );
+        passed = passed && ok;
+    }
+    printf( "\n" );
+    return passed;
+}
+
+struct SolveInteractive
+{
+    TriangleOfVelocitiesSolver& solver;
+    void operator()( TriangleOfVelocities& tov ) const { solver.solve( tov ); }
+};
+
+struct SolveSilent
+{
+    const TriangleOfVelocitiesSolver& solver;
+    void operator()( TriangleOfVelocities& tov ) const
+    {
+        const TriangleSolution solution = solver.solveSilent( tov );
+        tov.HDG = solution.HDG[0];
+        tov.GS  = solution.GS[0];
+    }
+};
+
+struct SolveKernel
+{
+    void operator()( TriangleOfVelocities& tov ) const
+    {
+        TriangleKernel< TriangleOfVelocitiesSolver::eFindHdgGs >::solve( tov.TR, tov.TAS, tov.W, tov.V, tov.HDG, tov.GS );
+    }
+};
+
+struct SolveLawOfCosines
+{
+    const TriangleOfVelocitiesSolver& solver;
+    void operator()( TriangleOfVelocities& tov ) const { solver.solveVecDirLength( tov ); }
+};
+
+struct SolveSineRule
+{
+    const TriangleOfVelocitiesSolver& solver;
+    void operator()( TriangleOfVelocities& tov ) const { solver.solveVecDirLength2( tov ); }
+};
+
+struct SolveVectorAlgebra
+{
+    const TriangleOfVelocitiesSolver& solver;
+    void operator()( TriangleOfVelocities& tov ) const { solver.solveVectorAlgebra( tov ); }
+};
+
+struct SolveTable
+{
+    const WindCorrectionTable&          table;
+    WindCorrectionTable::Interpolation  interp;
+    void operator()( TriangleOfVelocities& tov ) const
+    {
+        table.Lookup( tov.TR, tov.TAS, tov.W, tov.V, tov.HDG, tov.GS, interp );
+    }
+};
+
+// Precision policy: the kernels and GrapheneMath in every Scalar. The double and
+// long double solvers round their constants from long double, they have to stay
+// exact whatever GRAPHENE_PRECISION is ('make bench' also runs this at 1).
+static bool RunPrecisionPolicy( const BenchInputs& inputs, unsigned reps, const SolveSilent& silent )
+{
+    const double maxExactErrorHDG = 1e-9; //< DEG
+
+    printf( "\nPrecision policy (Scalar of the kernels and of GrapheneMath, GRAPHENE_PRECISION %d)\n", GRAPHENE_PRECISION );
+    printf( "%-34s %9s %10s %12s %12s %12s %12s\n",
+            "formulation", "ns/op", "Mtri/s", "max HDG", "rms HDG", "max GS", "rms GS" );
+
+    const BenchResult silentResult     = RunScalar( inputs, reps, silent );
+    const BenchResult doubleResult     = RunBatchPrecision<double, GRAPHENE_FAST_TRIG>( inputs, reps );
+    const BenchResult longDoubleResult = RunBatchPrecision<long double, GRAPHENE_FAST_TRIG>( inputs, reps );
+    Print( "solveSilent()", silentResult );
+    Print( "solveBatch<eFindHdgGs> float", RunBatchPrecision<float, GRAPHENE_FAST_TRIG>( inputs, reps ) );
+    Print( "solveBatch<eFindHdgGs> double", doubleResult );
+    Print( "solveBatch<eFindHdgGs> long double", longDoubleResult );
+    Print( "Quaternion rotate float", RunRotatePrecision<float>( inputs, reps ) );
+    Print( "Quaternion rotate double", RunRotatePrecision<double>( inputs, reps ) );
+    Print( "Quaternion rotate long double", RunRotatePrecision<long double>( inputs, reps ) );
+
+    // Polynomial trigonometry bounds the error on its own, only libm is held to exact.
+    if( GRAPHENE_FAST_TRIG != eTrigLibm )
+    {
+        return true;
+    }
+
+    const bool exact = ( silentResult.maxErrorHDG <= maxExactErrorHDG ) &&
+                       ( doubleResult.maxErrorHDG <= maxExactErrorHDG ) &&
+                       ( longDoubleResult.maxErrorHDG <= maxExactErrorHDG );
+    printf( "double and long double max HDG <= %.0e DEG: %s\n", maxExactErrorHDG, exact ? "ok" : "FAIL" );
+    return exact;
+}
+
+// 'NavexBench precision' runs only the precision policy.
+int main( int argc, char** argv )
+{
+    const size_t   count = 1 << 16;
+    const unsigned reps  = 20;
+
+    const BenchInputs inputs( count );
+    TriangleOfVelocitiesSolver solver;
+
+    if( ( argc > 1 ) && ( std::string( argv[1] ) == "precision" ) )
+    {
+        const SolveSilent silent = { solver };
+        return RunPrecisionPolicy( inputs, reps, silent ) ? 0 : 1;
+    }
+
+    // Same memory for both: 1440 x 200 nodes against 360 x 50 patches of 16 nodes.
+    WindCorrectionTable table;
+    table.Build( 1440, 200, 0.9 );
+    WindCorrectionTable cubicTable;
+    cubicTable.Build( 360, 50, 0.9 );
+
+    const SolveInteractive   interactive   = { solver };
+    const SolveSilent        silent        = { solver };
+    const SolveLawOfCosines  lawOfCosines  = { solver };
+    const SolveSineRule      sineRule      = { solver };
+    const SolveVectorAlgebra vectorAlgebra = { solver };
+    const SolveTable         bilinear      = { table, WindCorrectionTable::eBilinear };
+    const SolveTable         cubic         = { cubicTable, WindCorrectionTable::eCubic };
+
+    // solve() prints on every call, the console is muted to time the math.
+    NullBuffer nullBuffer;
+    std::streambuf* const coutBuffer = std::cout.rdbuf();
+
+    printf( "Reference triangles (Test 01, Test 02)\n" );
+    bool passed = true;
+    std::cout.rdbuf( &nullBuffer );
+    passed = CheckReference( "solve()", interactive ) && passed;
+    std::cout.rdbuf( coutBuffer );
+    passed = CheckReference( "solveSilent()", silent ) && passed;
+    passed = CheckReference( "TriangleKernel<eFindHdgGs>", SolveKernel() ) && passed;
+    passed = CheckReference( "solveVecDirLength() cosines", lawOfCosines ) && passed;
+    passed = CheckReference( "solveVecDirLength2() sines", sineRule ) && passed;
+    passed = CheckReference( "solveVectorAlgebra()", vectorAlgebra ) && passed;
+    passed = CheckReference( "WindCorrectionTable bilinear", bilinear ) && passed;
+    passed = CheckReference( "WindCorrectionTable cubic 360x50", cubic ) && passed;
+    printf( "\n" );
+
+    printf( "Triangle of velocities, %u random triangles (TAS 60-200 kts, V/TAS < 0.9) x %u\n",
+            static_cast<unsigned>( count ), reps );
+    printf( "%-34s %9s %10s %12s %12s %12s %12s\n",
+            "formulation", "ns/op", "Mtri/s", "max HDG", "rms HDG", "max GS", "rms GS" );
+
+    std::cout.rdbuf( &nullBuffer );
+    const BenchResult interactiveResult = RunScalar( inputs, 1, interactive );
+    std::cout.rdbuf( coutBuffer );
+    Print( "solve() (console muted)", interactiveResult );
+
+    const BenchResult silentResult = RunScalar( inputs, reps, silent );
+    Print( "solveSilent()", silentResult );
+    Print( "TriangleKernel<eFindHdgGs>", RunScalar( inputs, reps, SolveKernel() ) );
+    const BenchResult batchResult = RunBatch( inputs, reps );
+    Print( "solve( SoA batch )", batchResult );
+    const BenchResult floatResult = RunBatchPrecision<float, eTrig1e6>( inputs, reps );
+    Print( "solveBatch<eFindHdgGs> float", floatResult );
+    Print( "solveBatch<eFindHdgGs> libm loop", RunBatchPrecision<double, eTrigLibm>( inputs, reps ) );
+
+    Print( "solveVecDirLength() cosines", RunScalar( inputs, reps, lawOfCosines ) );
+    Print( "solveVecDirLength2() sines", RunScalar( inputs, reps, sineRule ) );
+    Print( "solveVectorAlgebra()", RunScalar( inputs, reps, vectorAlgebra ) );
+
+    Print( "WindCorrectionTable bilinear", RunScalar( inputs, reps, bilinear ) );
+    Print( "WindCorrectionTable cubic 360x50", RunScalar( inputs, reps, cubic ) );
+
+    printf( "\nSoA batch (%s, eTrig1e6) %.1fx solve(), %.1fx solveSilent(); float batch %.1fx solve()\n",
+            GRAPHENE_SIMD ? "SSE" : "scalar",
+            interactiveResult.nsPerOp / batchResult.nsPerOp, silentResult.nsPerOp / batchResult.nsPerOp,
+            interactiveResult.nsPerOp / floatResult.nsPerOp );
+
+    passed = RunPrecisionPolicy( inputs, reps, silent ) && passed;
+
+    printf( "\nWind estimator, fixes of W/V 240/35 (ns/sample, M samples/s, estimate)\n" );
+    RunWindEstimator( "WindEstimator exact fixes", count, reps, 0.0 );
+    RunWindEstimator( "WindEstimator 2 kts noise", count, reps, 2.0 );
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,423 @@
+// Triangle of velocities: differential validation of the W/V + TR + TAS -> HDG/GS
+// solvers against an independent vector reconstruction. Build and run with
+// 'make validate', optionally followed by the number of random triangles.
+//
+// Every answer (HDG, GS) is checked by flying it: the air vector (TAS rotated
+// to HDG with Quaternion::RotateFast) plus the wind vector (as WV::GetWV())
+// has to be the ground vector GS along TR. The number of solutions is checked
+// against the geometry of the same vectors: the circle of radius TAS around the
+// tip of the wind vector crosses the track line in 0, 1 or 2 points.
+// The wind envelope sweep is checked cell by cell the same way.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+#include "triangle.h"
+#include "windEnvelope.h"
+#include "windVector.h"
+
+// Largest accepted reconstruction error (kts) and the width of the band around
+// the tangent and zero GS cases in which the solution count of a random
+// triangle is not checked. Constructed tangent triangles have a known count.
+static const double c_maxErrorKt   = 1E-6;
+static const double c_borderlineKt = 1E-6;
+
+enum Region
+{
+    eTasAboveV = 0, //< TAS >= V, single solution
+    eTasBelowV,     //< TAS < V, two, one or no solution
+    eTangent,       //< TAS < V with the cross wind equal to TAS
+    eNumRegions
+};
+
+static const char* const c_regionNames[ eNumRegions ] = { "TAS >= V", "TAS < V", "tangent" };
+
+// Worst case of one check, with the triangle that caused it.
+struct WorstCase
+{
+    double               error; //< kts
+    TriangleOfVelocities tov;
+
+    WorstCase() : error( 0.0 ) {}
+
+    void Update( double err, const TriangleOfVelocities& input, double HDG, double GS )
+    {
+        // NaN always counts as the worst case.
+        if( err > error || err != err )
+        {
+            error   = ( err == err ) ? err : HUGE_VAL;
+            tov     = input;
+            tov.HDG = HDG;
+            tov.GS  = GS;
+        }
+    }
+
+    void Merge( const WorstCase& other )
+    {
+        if( other.error > error ) {
+            *this = other;
+        }
+    }
+};
+
+struct RegionStats
+{
+    uint64_t  triangles;
+    uint64_t  borderline;     //< solution count not checked
+    uint64_t  countMismatch;  //< wrong number of solutions
+    uint64_t  solutions;      //< answers checked by reconstruction
+    uint64_t  failed;         //< answers off by more than c_maxErrorKt
+    WorstCase worst;
+    WorstCase worstCount;     //< a triangle with the wrong number of solutions
+
+    RegionStats() : triangles( 0 ), borderline( 0 ), countMismatch( 0 ), solutions( 0 ), failed( 0 ) {}
+
+    void Merge( const RegionStats& other )
+    {
+        triangles     += other.triangles;
+        borderline    += other.borderline;
+        countMismatch += other.countMismatch;
+        solutions     += other.solutions;
+        failed        += other.failed;
+        worst.Merge( other.worst );
+        worstCount.Merge( other.worstCount );
+    }
+};
+
+// Results of one formulation over every region.
+struct FormulationStats
+{
+    RegionStats region[ eNumRegions ];
+
+    void Merge( const FormulationStats& other )
+    {
+        for( int i = 0; i < eNumRegions; ++i ) {
+            region[i].Merge( other.region[i] );
+        }
+    }
+};
+
+// Random triangle of the given region, TR, TAS, W and V set.
+static TriangleOfVelocities RandomTriangle( std::mt19937& rng, Region region )
+{
+    std::uniform_real_distribution<double> unit( 0.0, 1.0 );
+
+    TriangleOfVelocities tov;
+    tov.TR  = 360.0 * unit( rng );
+    tov.TAS = 40.0 + 210.0 * unit( rng );
+
+    switch( region )
+    {
+        case eTasAboveV:
+            tov.V = tov.TAS * unit( rng );
+            tov.W = 360.0 * unit( rng );
+            break;
+
+        case eTasBelowV:
+            tov.V = tov.TAS * ( 1.0 + 2.0 * unit( rng ) );
+            tov.W = 360.0 * unit( rng );
+            break;
+
+        default:
+        {
+            // V * sin( W - TR ) = +-TAS, on either side of the track, head or tail wind.
+            tov.V = tov.TAS * ( 1.05 + 2.0 * unit( rng ) );
+            const double rel = Rad2Deg( asin( tov.TAS / tov.V ) );
+            const double relWind[ 4 ] = { rel, 180.0 - rel, 180.0 + rel, 360.0 - rel };
+            tov.W = TriangleKernelBase::wrap360( tov.TR + relWind[ rng() % 4 ] );
+            break;
+        }
+    }
+    return tov;
+}
+
+// Independent reference built from the vectors alone.
+struct Reference
+{
+    Vector3<double> track; //< unit vector along TR
+    Vector3<double> wind;  //< wind velocity (kts)
+    int             numSolutions;
+    bool            borderline;
+
+    // 'tangent' for a triangle constructed with the cross wind equal to TAS.
+    explicit Reference( const TriangleOfVelocities& tov, bool tangent = false )
+        : track( DirectionVector( tov.TR ) )
+        , wind( WindVector( tov.W, tov.V ) )
+    {
+        // Ground vector s * track with | s * track - wind | = TAS.
+        const double along = wind.Dot( track );
+        const double cross = wind.Cross( track ).Mag();
+        const double disc  = tov.TAS * tov.TAS - cross * cross;
+        const double root  = sqrt( std::max( disc, 0.0 ) );
+
+        if( tangent )
+        {
+            // Double root s = along, rounding decides the sign of 'disc'. One
+            // solution with the wind behind the beam, none ahead of it; |along|
+            // is at least 0.3 TAS (V >= 1.05 TAS), far from the zero GS case.
+            numSolutions = ( along > 0.0 ) ? 1 : 0;
+            borderline   = false;
+            return;
+        }
+
+        numSolutions = ( disc < 0.0 ) ? 0 : ( ( along + root > 0.0 ) ? 1 : 0 ) + ( ( along - root > 0.0 ) ? 1 : 0 );
+        borderline   = ( fabs( cross - tov.TAS ) < c_borderlineKt ) ||
+                       ( fabs( along + root ) < c_borderlineKt ) ||
+                       ( fabs( along - root ) < c_borderlineKt );
+    }
+
+    // Distance (kts) between the flown ground vector and GS along TR.
+    double Error( const TriangleOfVelocities& tov, double HDG, double GS ) const
+    {
+        const Vector3<double> ground = AirVector( HDG, tov.TAS ) + wind;
+        return ( ground - track.ScalarMult( GS ) ).Mag();
+    }
+};
+
+static void CheckSolution( RegionStats& stats, const Reference& ref, const TriangleOfVelocities& tov, double HDG, double GS )
+{
+    const double error = ref.Error( tov, HDG, GS );
+    ++stats.solutions;
+    stats.failed += ( error <= c_maxErrorKt ) ? 0 : 1;
+    stats.worst.Update( error, tov, HDG, GS );
+}
+
+static void CheckCount( RegionStats& stats, const Reference& ref, const TriangleOfVelocities& tov, int numSolutions, double HDG, double GS )
+{
+    ++stats.triangles;
+    if( ref.borderline )
+    {
+        ++stats.borderline;
+    }
+    else if( numSolutions != ref.numSolutions )
+    {
+        ++stats.countMismatch;
+        stats.worstCount.Update( fabs( double( numSolutions - ref.numSolutions ) ), tov, HDG, GS );
+    }
+}
+
+// Thread safe checks: solveSilent() on every region, the batch kernel where it
+// applies (TAS >= V).
+static void ValidateSilent( unsigned seed, uint64_t count, FormulationStats* silent, FormulationStats* kernel )
+{
+    std::mt19937 rng( seed );
+    const TriangleOfVelocitiesSolver solver;
+
+    for( uint64_t i = 0; i < count; ++i )
+    {
+        const Region region = static_cast<Region>( i % eNumRegions );
+        const TriangleOfVelocities tov = RandomTriangle( rng, region );
+        const Reference ref( tov, region == eTangent );
+
+        const TriangleSolution solution = solver.solveSilent( tov );
+        RegionStats& silentStats = silent->region[ region ];
+        CheckCount( silentStats, ref, tov, solution.numSolutions, solution.HDG[0], solution.GS[0] );
+        for( int s = 0; s < solution.numSolutions; ++s ) {
+            CheckSolution( silentStats, ref, tov, solution.HDG[s], solution.GS[s] );
+        }
+
+        if( region == eTasAboveV )
+        {
+            TriangleOfVelocities k = tov;
+            TriangleKernel< TriangleOfVelocitiesSolver::eFindHdgGs >::solve( k.TR, k.TAS, k.W, k.V, k.HDG, k.GS );
+            RegionStats& kernelStats = kernel->region[ region ];
+            CheckCount( kernelStats, ref, tov, 1, k.HDG, k.GS );
+            CheckSolution( kernelStats, ref, tov, k.HDG, k.GS );
+        }
+    }
+}
+
+// solve() prints on every call and so runs on the calling thread only, console
+// muted. It always returns one answer, also for triangles without a solution.
+static void ValidateInteractive( unsigned seed, uint64_t count, FormulationStats* interactive )
+{
+    std::mt19937 rng( seed );
+    TriangleOfVelocitiesSolver solver;
+
+    for( uint64_t i = 0; i < count; ++i )
+    {
+        const Region region = static_cast<Region>( i % eNumRegions );
+        TriangleOfVelocities tov = RandomTriangle( rng, region );
+        const Reference ref( tov, region == eTangent );
+
+        solver.solve( tov );
+        RegionStats& stats = interactive->region[ region ];
+
+        // Its one answer is one of the solutions if there are any, a wrong
+        // count is an answer to an impossible triangle.
+        CheckCount( stats, ref, tov, ( ref.numSolutions > 0 ) ? ref.numSolutions : 1, tov.HDG, tov.GS );
+        CheckSolution( stats, ref, tov, tov.HDG, tov.GS );
+    }
+}
+
+// Wind envelope of a slow leg, TR 090 TAS 60 kts with winds up to 80 kts, where
+// strong crosswinds and headwinds can't be flown, and of a fast one, TAS 100,
+// where every wind can. A grid cell must be NaN exactly when the reference has
+// no solution and fly its answer otherwise; the summaries only cover feasible
+// cells. Returns false on a mismatch.
+static bool ValidateEnvelope()
+{
+    const double TR[ 2 ]  = { 90.0, 90.0 };
+    const double TAS[ 2 ] = { 60.0, 100.0 };
+
+    WindEnvelopeSweep sweep( 1.0, 1.0, 80.0 );
+    sweep.Run( TR, TAS, 2 );
+
+    uint64_t cells = 0, borderline = 0, infeasible = 0, mismatch = 0, failed = 0;
+    for( size_t leg = 0; leg < sweep.GetNumLegs(); ++leg )
+    {
+        for( size_t speedIdx = 0; speedIdx < sweep.GetNumSpeeds(); ++speedIdx )
+        {
+            for( size_t dirIdx = 0; dirIdx < sweep.GetNumDirs(); ++dirIdx )
+            {
+                TriangleOfVelocities tov;
+                tov.TR  = TR[ leg ];
+                tov.TAS = TAS[ leg ];
+                tov.W   = sweep.GetDir( dirIdx );
+                tov.V   = sweep.GetSpeed( speedIdx );
+                const Reference ref( tov );
+
+                const double HDG = sweep.GetHDG( leg, speedIdx, dirIdx );
+                const double GS  = sweep.GetGS( leg, speedIdx, dirIdx );
+                const bool flagged = ( GS != GS );
+
+                ++cells;
+                infeasible += flagged ? 1 : 0;
+                if( ref.borderline ) {
+                    ++borderline;
+                }
+                else if( flagged != ( ref.numSolutions == 0 ) ) {
+                    ++mismatch;
+                }
+                if( !flagged && !( ref.Error( tov, HDG, GS ) <= c_maxErrorKt ) ) {
+                    ++failed;
+                }
+            }
+        }
+    }
+
+    const WindEnvelopeSummary& slow = sweep.GetSummary( 0 );
+    const WindEnvelopeSummary& fast = sweep.GetSummary( 1 );
+    const bool slowOk = !slow.solvable && slow.numInfeasible > 0 &&
+                        slow.numFeasible + slow.numInfeasible == sweep.GetNumSpeeds() * sweep.GetNumDirs() &&
+                        fabs( slow.minGS - 1.0 ) < c_maxErrorKt && fabs( slow.maxDrift ) < 90.0 &&
+                        fabs( slow.maxGS - 140.0 ) < c_maxErrorKt;
+    const bool fastOk = fast.solvable && fast.numInfeasible == 0 &&
+                        fabs( fast.minGS - 20.0 ) < c_maxErrorKt &&
+                        fabs( fabs( fast.maxDrift ) - Rad2Deg( asin( 0.8 ) ) ) < 1E-9;
+
+    printf( "Wind envelope: %llu cells, %llu infeasible, %llu borderline, %llu bad flags, %llu failed\n",
+            static_cast<unsigned long long>( cells ), static_cast<unsigned long long>( infeasible ),
+            static_cast<unsigned long long>( borderline ), static_cast<unsigned long long>( mismatch ),
+            static_cast<unsigned long long>( failed ) );
+    printf( "    TAS  60: GS %.3f..%.3f kts, drift %.3f DEG, %s\n", slow.minGS, slow.maxGS, slow.maxDrift, slowOk ? "ok" : "WRONG" );
+    printf( "    TAS 100: GS %.3f..%.3f kts, drift %.3f DEG, %s\n", fast.minGS, fast.maxGS, fast.maxDrift, fastOk ? "ok" : "WRONG" );
+
+    return ( mismatch == 0 ) && ( failed == 0 ) && slowOk && fastOk;
+}
+
+// Discards everything written to it, mutes the console output of solve().
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow( int c ) { return c; }
+};
+
+static bool Report( const char* name, const FormulationStats& stats )
+{
+    bool passed = true;
+    for( int r = 0; r < eNumRegions; ++r )
+    {
+        const RegionStats& s = stats.region[r];
+        if( s.triangles == 0 ) {
+            continue;
+        }
+
+        printf( "%-14s %-9s %10llu %10llu %10llu %10llu %10llu %12.3e\n",
+                name, c_regionNames[r],
+                static_cast<unsigned long long>( s.triangles ),
+                static_cast<unsigned long long>( s.borderline ),
+                static_cast<unsigned long long>( s.countMismatch ),
+                static_cast<unsigned long long>( s.solutions ),
+                static_cast<unsigned long long>( s.failed ),
+                s.worst.error );
+
+        if( s.failed )
+        {
+            const TriangleOfVelocities& t = s.worst.tov;
+            printf( "    worst answer: TR %.6f TAS %.6f W %.6f V %.6f -> HDG %.6f GS %.6f\n",
+                    t.TR, t.TAS, t.W, t.V, t.HDG, t.GS );
+        }
+        if( s.countMismatch )
+        {
+            const TriangleOfVelocities& t = s.worstCount.tov;
+            printf( "    wrong count:  TR %.6f TAS %.6f W %.6f V %.6f -> HDG %.6f GS %.6f\n",
+                    t.TR, t.TAS, t.W, t.V, t.HDG, t.GS );
+        }
+        passed = passed && ( s.failed == 0 ) && ( s.countMismatch == 0 );
+    }
+    return passed;
+}
+
+int main( int argc, char** argv )
+{
+    const uint64_t count            = ( argc > 1 ) ? strtoull( argv[1], NULL, 10 ) : 6000000;
+    const uint64_t interactiveCount = std::min<uint64_t>( count, 300000 );
+    const unsigned numThreads       = std::max( 1u, std::thread::hardware_concurrency() );
+
+    // Every thread validates its own share with its own random sequence.
+    std::vector<FormulationStats> silent( numThreads ), kernel( numThreads );
+    std::vector<std::thread> workers;
+
+    Benchmark::Timer timer;
+    for( unsigned t = 0; t < numThreads; ++t )
+    {
+        const uint64_t share = count / numThreads + ( ( t < count % numThreads ) ? 1 : 0 );
+        workers.push_back( std::thread( ValidateSilent, 1000 + t, share, &silent[t], &kernel[t] ) );
+    }
+    for( unsigned t = 0; t < numThreads; ++t ) {
+        workers[t].join();
+    }
+    const double silentNs = timer.ElapsedNs();
+
+    for( unsigned t = 1; t < numThreads; ++t )
+    {
+        silent[0].Merge( silent[t] );
+        kernel[0].Merge( kernel[t] );
+    }
+
+    FormulationStats interactive;
+    NullBuffer nullBuffer;
+    std::streambuf* const coutBuffer = std::cout.rdbuf( &nullBuffer );
+    timer.Start();
+    ValidateInteractive( 1, interactiveCount, &interactive );
+    const double interactiveNs = timer.ElapsedNs();
+    std::cout.rdbuf( coutBuffer );
+
+    printf( "Triangle of velocities validation, %llu random triangles on %u threads: %.2f M triangles/s\n",
+            static_cast<unsigned long long>( count ), numThreads, count / silentNs * 1000.0 );
+    printf( "solve() on %llu triangles, one thread (console muted): %.2f M triangles/s\n\n",
+            static_cast<unsigned long long>( interactiveCount ), interactiveCount / interactiveNs * 1000.0 );
+
+    printf( "%-14s %-9s %10s %10s %10s %10s %10s %12s\n",
+            "formulation", "region", "triangles", "borderline", "bad count", "answers", "failed", "worst (kts)" );
+    bool passed = Report( "solveSilent()", silent[0] );
+    passed = Report( "kernel", kernel[0] ) && passed;
+
+    // solve() has known issues (|HDG| when crossing North, GS 0 in calm wind, an
+    // answer for impossible triangles), reported only.
+    Report( "solve()", interactive );
+
+    printf( "\n" );
+    passed = ValidateEnvelope() && passed;
+
+    printf( "\n%s\n", passed ? "PASSED" : "FAILED" );
+    return passed ? 0 : 1;
+}
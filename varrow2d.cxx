@@ -2,6 +2,14 @@
 
 using namespace GrapheneMath;
 
+namespace
+{
+    // Arrow head lines are at 45 DEG to the shaft, cosine and sine of the
+    // quaternion half angle evaluated at compile time.
+    constexpr float c_cosHalf45 = ConstCos( Deg2Rad( 22.5f ) );
+    constexpr float c_sinHalf45 = ConstSin( Deg2Rad( 22.5f ) );
+}
+
 Varrow2D::Varrow2D( )
 {
     m_lines.resize( c_numOfLines );
@@ -14,24 +22,24 @@ void Varrow2D::Set( const Vector3<float>&   pos,
                     float length )
   { 
       const Vector3<float>& opposiDir = dir.ScalarMult( -1.0f );
-      Quaternion<float> rot;
+      assert( planeNormal.IsUnit() );
+      Quaternion<float> rot = Quaternion<float>::FromAxisCosSin( planeNormal, c_cosHalf45, c_sinHalf45 );
       
-      rot.FromAxisAngle( planeNormal, Deg2Rad( 45.0f ) );
       Vector3<float> v = rot.RotateFast( opposiDir );
       m_lines[0].SetFrom( pos );
       m_lines[0].SetTo( pos + v.ScalarMult( length ) );
       m_lines[0].SetColor( color );
       
-      rot.FromAxisAngle( planeNormal, Deg2Rad( -45.0f ) );
+      rot = Quaternion<float>::FromAxisCosSin( planeNormal, c_cosHalf45, -c_sinHalf45 );
       v = rot.RotateFast( opposiDir );
       m_lines[1].SetFrom( pos );
       m_lines[1].SetTo( pos + v.ScalarMult( length ) );
       m_lines[1].SetColor( color );
   }
   
-  void Varrow2D::Draw() const
+  void Varrow2D::Draw( LineBatch& batch ) const
   { 
     for( unsigned int i = 0; i < c_numOfLines; ++i ) {
-        m_lines[i].Draw();
+        batch.Add( m_lines[i] );
     }
   }
\ No newline at end of file
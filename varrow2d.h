@@ -7,6 +7,7 @@
 #include "mathUtils.h"
 #include "quat.h"
 #include "glLine.h"
+#include "lineBatch.h"
 
 using namespace GrapheneMath;
 
@@ -25,7 +26,7 @@ public:
             const Vector3<GLfloat>& color,
             float length );
   
-  void Draw() const;
+  void Draw( LineBatch& batch ) const;
 };
 
 #endif //__VARROW2D_H__
@@ -2,19 +2,26 @@
 #define __VECTOR3_H__
 
 #include "mathUtils.h"
+#include "simdTraits.h"
+#include "fastTrig.h"
 
 namespace GrapheneMath
 {
-    template <typename Scalar>
+    // Three dimensional vector class.
+    // For float and double with SIMD enabled the specialisation below is used,
+    // Vector3<Scalar, false> always selects this portable version.
+    // Construction, the getters and the arithmetic operators are constexpr,
+    // so fixed geometry can be computed at compile time.
+    template <typename Scalar, bool Simd = SimdTraits<Scalar>::enabled>
     class Vector3
     {
     private:
         Scalar x, y, z;
 
     public:
-        Vector3(const Scalar& _x = Scalar{},
-                const Scalar& _y = Scalar{},
-                const Scalar& _z = Scalar{})
+        constexpr Vector3(const Scalar& _x = Scalar{},
+                          const Scalar& _y = Scalar{},
+                          const Scalar& _z = Scalar{})
             : x(_x), y(_y), z(_z)
         {}
 
@@ -22,9 +29,9 @@ namespace GrapheneMath
         inline void SetY(Scalar _y) { y = _y; }
         inline void SetZ(Scalar _z) { z = _z; }
 
-        inline const Scalar GetX() const { return x; }
-        inline const Scalar GetY() const { return y; }
-        inline const Scalar GetZ() const { return z; }
+        constexpr Scalar GetX() const { return x; }
+        constexpr Scalar GetY() const { return y; }
+        constexpr Scalar GetZ() const { return z; }
 
         // Setter function that sets vector x, y, z, w components.
         void SetXYZ(Scalar _x, Scalar _y, Scalar _z)
@@ -32,13 +39,13 @@ namespace GrapheneMath
             x = _x; y = _y; z = _z;
         }
         
-        const Vector3<Scalar> operator+(const Vector3<Scalar>& vec) const;
-        const Vector3<Scalar> operator+=(const Vector3<Scalar>& vec);
-        const Vector3<Scalar> operator-(const Vector3<Scalar>& vec) const;
-        const Vector3<Scalar> operator-=(const Vector3<Scalar>& vec);
-        const Vector3<Scalar> ScalarMult(Scalar scalar) const;
-        const Scalar Dot(const Vector3<Scalar>& vec) const;
-        const Vector3<Scalar> Cross(const Vector3<Scalar>& vec) const;
+        constexpr const Vector3 operator+(const Vector3& vec) const;
+        Vector3& operator+=(const Vector3& vec);
+        constexpr const Vector3 operator-(const Vector3& vec) const;
+        Vector3& operator-=(const Vector3& vec);
+        constexpr const Vector3 ScalarMult(Scalar scalar) const;
+        constexpr const Scalar Dot(const Vector3& vec) const;
+        constexpr const Vector3 Cross(const Vector3& vec) const;
     
         const Scalar Mag() const
         {
@@ -58,64 +65,64 @@ namespace GrapheneMath
 
         bool IsUnit() const
         {
-            return (abs(Mag() - ONE) < NUM_TOLERANCE) ? true : false;
+            return (fabs(Mag() - Scalar(ONE)) < Constants<Scalar>::NumTolerance()) ? true : false;
         }
 
         // Numerically stable way to calculate the angle between
         // two vectors.
-        const Scalar GetAngle(const Vector3<Scalar>& b) const;
+        const Scalar GetAngle(const Vector3& b) const;
     };
     
-    template <typename Scalar>
-    const Vector3<Scalar> Vector3<Scalar>::operator+(const Vector3<Scalar>& vec) const
+    template <typename Scalar, bool Simd>
+    constexpr const Vector3<Scalar, Simd> Vector3<Scalar, Simd>::operator+(const Vector3<Scalar, Simd>& vec) const
     {
         return Vector3(x + vec.x, y + vec.y, z + vec.z);
     }
 
-    template <typename Scalar>
-    const Vector3<Scalar> Vector3<Scalar>::operator+=(const Vector3<Scalar>& vec)
+    template <typename Scalar, bool Simd>
+    Vector3<Scalar, Simd>& Vector3<Scalar, Simd>::operator+=(const Vector3<Scalar, Simd>& vec)
     {
         x += vec.x; y += vec.y; z += vec.z;
         return *this;
     }
     
-    template <typename Scalar>
-    const Vector3<Scalar> Vector3<Scalar>::operator-(const Vector3<Scalar>& vec) const
+    template <typename Scalar, bool Simd>
+    constexpr const Vector3<Scalar, Simd> Vector3<Scalar, Simd>::operator-(const Vector3<Scalar, Simd>& vec) const
     {
         return Vector3(x - vec.x, y - vec.y, z - vec.z);
     }
     
-    template <typename Scalar>
-    const Vector3<Scalar> Vector3<Scalar>::operator-=(const Vector3<Scalar>& vec)
+    template <typename Scalar, bool Simd>
+    Vector3<Scalar, Simd>& Vector3<Scalar, Simd>::operator-=(const Vector3<Scalar, Simd>& vec)
     {
         x -= vec.x; y -= vec.y; z -= vec.z;
         return *this;
     }
 
-    template <typename Scalar>
-    const Vector3<Scalar> Vector3<Scalar>::ScalarMult(Scalar scalar) const
+    template <typename Scalar, bool Simd>
+    constexpr const Vector3<Scalar, Simd> Vector3<Scalar, Simd>::ScalarMult(Scalar scalar) const
     {
         return Vector3(x * scalar, y * scalar, z * scalar);
     }
 
     // Vector scalar product operator.
-    template <typename Scalar>
-    const Scalar Vector3<Scalar>::Dot(const Vector3<Scalar>& vec) const
+    template <typename Scalar, bool Simd>
+    constexpr const Scalar Vector3<Scalar, Simd>::Dot(const Vector3<Scalar, Simd>& vec) const
     {
         return (x * vec.x + y * vec.y + z * vec.z);
     }
 
     // Vector cross product operator.
-    template <typename Scalar>
-    const Vector3<Scalar> Vector3<Scalar>::Cross(const Vector3<Scalar>& vec) const
+    template <typename Scalar, bool Simd>
+    constexpr const Vector3<Scalar, Simd> Vector3<Scalar, Simd>::Cross(const Vector3<Scalar, Simd>& vec) const
     {
        return Vector3(y * vec.z - z * vec.y,
                       z * vec.x - x * vec.z,
                       x * vec.y - y * vec.x);
     }
     
-    template <typename Scalar>
-    const Scalar Vector3<Scalar>::GetAngle(const Vector3<Scalar>& b) const
+    template <typename Scalar, bool Simd>
+    const Scalar Vector3<Scalar, Simd>::GetAngle(const Vector3<Scalar, Simd>& b) const
     {
         const Vector3& a = *this;
 
@@ -124,13 +131,134 @@ namespace GrapheneMath
 
         if (a.Dot(b) < Scalar(0.0))
         {
-            return Scalar(PI) - Scalar(TWO) * asin((b.ScalarMult(Scalar(-1.0)) - a).Mag() / Scalar(TWO));
+            return Constants<Scalar>::Pi() - Scalar(TWO) * Trig<Scalar>::Asin((b.ScalarMult(Scalar(-1.0)) - a).Mag() / Scalar(TWO));
         }
         else
         {
-            return Scalar(TWO) * asin((b - a).Mag() / Scalar(TWO));
+            return Scalar(TWO) * Trig<Scalar>::Asin((b - a).Mag() / Scalar(TWO));
         }
     }
 
+    // SIMD version for float and double, same public API.
+    // Components are stored padded to four lanes (the fourth is always zero)
+    // and 16 byte aligned, every operator is one SSE operation (two SSE2
+    // operations for double). Only construction and the getters are constexpr
+    // here (intrinsics are not), compile-time tables are built from literal
+    // components.
+    template <typename Scalar>
+    class Vector3<Scalar, true>
+    {
+    private:
+        typedef SimdTraits<Scalar> Simd;
+
+        alignas(16) Scalar m_data[4]; //< x, y, z, 0
+
+    public:
+        constexpr Vector3(const Scalar& _x = Scalar{},
+                          const Scalar& _y = Scalar{},
+                          const Scalar& _z = Scalar{})
+            : m_data{ _x, _y, _z, Scalar{} }
+        {}
+
+        inline void SetX(Scalar _x) { m_data[0] = _x; }
+        inline void SetY(Scalar _y) { m_data[1] = _y; }
+        inline void SetZ(Scalar _z) { m_data[2] = _z; }
+
+        constexpr Scalar GetX() const { return m_data[0]; }
+        constexpr Scalar GetY() const { return m_data[1]; }
+        constexpr Scalar GetZ() const { return m_data[2]; }
+
+        // Setter function that sets vector x, y, z components.
+        void SetXYZ(Scalar _x, Scalar _y, Scalar _z)
+        {
+            m_data[0] = _x; m_data[1] = _y; m_data[2] = _z;
+        }
+
+        const Vector3 operator+(const Vector3& vec) const
+        {
+            Vector3 result;
+            Simd::Add(m_data, vec.m_data, result.m_data);
+            return result;
+        }
+
+        Vector3& operator+=(const Vector3& vec)
+        {
+            Simd::Add(m_data, vec.m_data, m_data);
+            return *this;
+        }
+
+        const Vector3 operator-(const Vector3& vec) const
+        {
+            Vector3 result;
+            Simd::Sub(m_data, vec.m_data, result.m_data);
+            return result;
+        }
+
+        Vector3& operator-=(const Vector3& vec)
+        {
+            Simd::Sub(m_data, vec.m_data, m_data);
+            return *this;
+        }
+
+        const Vector3 ScalarMult(Scalar scalar) const
+        {
+            Vector3 result;
+            Simd::Scale(m_data, scalar, result.m_data);
+            return result;
+        }
+
+        // Vector scalar product operator.
+        const Scalar Dot(const Vector3& vec) const
+        {
+            return Simd::Dot(m_data, vec.m_data);
+        }
+
+        // Vector cross product operator.
+        const Vector3 Cross(const Vector3& vec) const
+        {
+            Vector3 result;
+            Simd::Cross(m_data, vec.m_data, result.m_data);
+            return result;
+        }
+
+        const Scalar Mag() const
+        {
+            return sqrt(Simd::Dot(m_data, m_data));
+        }
+
+        void Normalise()
+        {
+            const Scalar mag = Mag();
+            if (mag)
+            {
+                Simd::Div(m_data, mag, m_data);
+            }
+        }
+
+        bool IsUnit() const
+        {
+            return (fabs(Mag() - Scalar(ONE)) < Constants<Scalar>::NumTolerance()) ? true : false;
+        }
+
+        // Numerically stable way to calculate the angle between
+        // two vectors.
+        const Scalar GetAngle(const Vector3& b) const
+        {
+            const Vector3& a = *this;
+
+            assert(a.IsUnit());
+            assert(b.IsUnit());
+
+            if (a.Dot(b) < Scalar(0.0))
+            {
+                return Constants<Scalar>::Pi() - Scalar(TWO) * Trig<Scalar>::Asin((b.ScalarMult(Scalar(-1.0)) - a).Mag() / Scalar(TWO));
+            }
+            else
+            {
+                return Scalar(TWO) * Trig<Scalar>::Asin((b - a).Mag() / Scalar(TWO));
+            }
+        }
+    };
+
 }  //< End of GrapheneMath namespace.
 #endif // __VECTOR3_H__
@@ -2,11 +2,15 @@
 #define __VECTOR4_H__
 
 #include "mathUtils.h"
+#include "simdTraits.h"
 
 namespace GrapheneMath
 {
     // Four dimensional vector class.
-    template <typename Scalar>
+    // For float and double with SIMD enabled the specialisation below is used,
+    // Vector4<Scalar, false> always selects this portable version.
+    // Construction, the getters and the arithmetic operators are constexpr.
+    template <typename Scalar, bool Simd = SimdTraits<Scalar>::enabled>
     class Vector4
     {
         // Holds vector x, y, z, w components.
@@ -14,10 +18,10 @@ namespace GrapheneMath
         Scalar x, y, z, w;
 
     public:
-        Vector4(const Scalar& _x = Scalar{},
-                const Scalar& _y = Scalar{},
-                const Scalar& _z = Scalar{},
-                const Scalar& _w = Scalar{})
+        constexpr Vector4(const Scalar& _x = Scalar{},
+                          const Scalar& _y = Scalar{},
+                          const Scalar& _z = Scalar{},
+                          const Scalar& _w = Scalar{})
             : x(_x), y(_y), z(_z), w(_w)
         {}
 
@@ -26,10 +30,10 @@ namespace GrapheneMath
         inline void SetZ(Scalar _z) { z = _z; }
         inline void SetW(Scalar _w) { w = _w; }
 
-        inline const Scalar GetX() const { return x; }
-        inline const Scalar GetY() const { return y; }
-        inline const Scalar GetZ() const { return z; }
-        inline const Scalar GetW() const { return w; }
+        constexpr Scalar GetX() const { return x; }
+        constexpr Scalar GetY() const { return y; }
+        constexpr Scalar GetZ() const { return z; }
+        constexpr Scalar GetW() const { return w; }
 
         // Setter function that sets vector x, y, z, w components.
         void SetXYZW(Scalar _x, Scalar _y, Scalar _z, Scalar _w)
@@ -37,14 +41,14 @@ namespace GrapheneMath
             x = _x; y = _y; z = _z; w = _w;
         }
 
-        const Vector4<Scalar> operator+(const Vector4<Scalar>& vec) const;
-        const Vector4<Scalar> operator+=(const Vector4<Scalar>& vec);
-        const Vector4<Scalar> operator-(const Vector4<Scalar>& vec) const;
-        const Vector4<Scalar> operator-=(const Vector4<Scalar>& vec);
-        const Vector4<Scalar> ScalarMult(Scalar scalar) const;
+        constexpr const Vector4 operator+(const Vector4& vec) const;
+        Vector4& operator+=(const Vector4& vec);
+        constexpr const Vector4 operator-(const Vector4& vec) const;
+        Vector4& operator-=(const Vector4& vec);
+        constexpr const Vector4 ScalarMult(Scalar scalar) const;
       
         // Vector scalar product operator.
-        const Scalar Dot(const Vector4<Scalar>& vec) const;
+        constexpr const Scalar Dot(const Vector4& vec) const;
       
         const Scalar Mag() const
         {
@@ -65,48 +69,143 @@ namespace GrapheneMath
 
         bool IsUnit() const
         {
-            return (abs(Mag() - ONE) < NUM_TOLERANCE) ? true : false;
+            return (fabs(Mag() - Scalar(ONE)) < Constants<Scalar>::NumTolerance()) ? true : false;
         }
     };  //< End of Vector4 class.
     
-    template <typename Scalar>
-    const Vector4<Scalar> Vector4<Scalar>::operator+(const Vector4<Scalar>& vec) const
+    template <typename Scalar, bool Simd>
+    constexpr const Vector4<Scalar, Simd> Vector4<Scalar, Simd>::operator+(const Vector4<Scalar, Simd>& vec) const
     {
        return Vector4(x + vec.x, y + vec.y, z + vec.z, w + vec.w);
     }
 
-    template <typename Scalar>
-    const Vector4<Scalar> Vector4<Scalar>::operator+=(const Vector4<Scalar>& vec)
+    template <typename Scalar, bool Simd>
+    Vector4<Scalar, Simd>& Vector4<Scalar, Simd>::operator+=(const Vector4<Scalar, Simd>& vec)
     {
         x += vec.x; y += vec.y; z += vec.z, w += vec.w;
         return *this;
     }
 
-    template <typename Scalar>
-    const Vector4<Scalar> Vector4<Scalar>::operator-(const Vector4<Scalar>& vec) const
+    template <typename Scalar, bool Simd>
+    constexpr const Vector4<Scalar, Simd> Vector4<Scalar, Simd>::operator-(const Vector4<Scalar, Simd>& vec) const
     {
         return Vector4(x - vec.x, y - vec.y, z - vec.z, w - vec.w);
     }
 
-    template <typename Scalar>
-    const Vector4<Scalar> Vector4<Scalar>::operator-=(const Vector4<Scalar>& vec)
+    template <typename Scalar, bool Simd>
+    Vector4<Scalar, Simd>& Vector4<Scalar, Simd>::operator-=(const Vector4<Scalar, Simd>& vec)
     {
         x -= vec.x; y -= vec.y; z -= vec.z, w -= vec.w;
         return *this;
     }
 
-    template <typename Scalar>
-    const Vector4<Scalar> Vector4<Scalar>::ScalarMult(Scalar scalar) const
+    template <typename Scalar, bool Simd>
+    constexpr const Vector4<Scalar, Simd> Vector4<Scalar, Simd>::ScalarMult(Scalar scalar) const
     {
         return Vector4(x * scalar, y * scalar, z * scalar, w * scalar);
     }
 
     // Vector scalar product operator.
-    template <typename Scalar>
-    const Scalar Vector4<Scalar>::Dot(const Vector4<Scalar>& vec) const
+    template <typename Scalar, bool Simd>
+    constexpr const Scalar Vector4<Scalar, Simd>::Dot(const Vector4<Scalar, Simd>& vec) const
     {
         return (x * vec.x + y * vec.y + z * vec.z + w * vec.w);
     }
         
+    // SIMD version for float and double, same public API.
+    // Components are stored 16 byte aligned, every operator is one SSE
+    // operation (two SSE2 operations for double). Only construction and the
+    // getters are constexpr.
+    template <typename Scalar>
+    class Vector4<Scalar, true>
+    {
+        typedef SimdTraits<Scalar> Simd;
+
+        // Holds vector x, y, z, w components.
+        alignas(16) Scalar m_data[4];
+
+    public:
+        constexpr Vector4(const Scalar& _x = Scalar{},
+                          const Scalar& _y = Scalar{},
+                          const Scalar& _z = Scalar{},
+                          const Scalar& _w = Scalar{})
+            : m_data{ _x, _y, _z, _w }
+        {}
+
+        inline void SetX(Scalar _x) { m_data[0] = _x; }
+        inline void SetY(Scalar _y) { m_data[1] = _y; }
+        inline void SetZ(Scalar _z) { m_data[2] = _z; }
+        inline void SetW(Scalar _w) { m_data[3] = _w; }
+
+        constexpr Scalar GetX() const { return m_data[0]; }
+        constexpr Scalar GetY() const { return m_data[1]; }
+        constexpr Scalar GetZ() const { return m_data[2]; }
+        constexpr Scalar GetW() const { return m_data[3]; }
+
+        // Setter function that sets vector x, y, z, w components.
+        void SetXYZW(Scalar _x, Scalar _y, Scalar _z, Scalar _w)
+        {
+            m_data[0] = _x; m_data[1] = _y; m_data[2] = _z; m_data[3] = _w;
+        }
+
+        const Vector4 operator+(const Vector4& vec) const
+        {
+            Vector4 result;
+            Simd::Add(m_data, vec.m_data, result.m_data);
+            return result;
+        }
+
+        Vector4& operator+=(const Vector4& vec)
+        {
+            Simd::Add(m_data, vec.m_data, m_data);
+            return *this;
+        }
+
+        const Vector4 operator-(const Vector4& vec) const
+        {
+            Vector4 result;
+            Simd::Sub(m_data, vec.m_data, result.m_data);
+            return result;
+        }
+
+        Vector4& operator-=(const Vector4& vec)
+        {
+            Simd::Sub(m_data, vec.m_data, m_data);
+            return *this;
+        }
+
+        const Vector4 ScalarMult(Scalar scalar) const
+        {
+            Vector4 result;
+            Simd::Scale(m_data, scalar, result.m_data);
+            return result;
+        }
+
+        // Vector scalar product operator.
+        const Scalar Dot(const Vector4& vec) const
+        {
+            return Simd::Dot(m_data, vec.m_data);
+        }
+
+        const Scalar Mag() const
+        {
+            return sqrt(Simd::Dot(m_data, m_data));
+        }
+
+        void Normalise()
+        {
+            const Scalar mag = Mag();
+            if(mag)
+            {
+                Simd::Div(m_data, mag, m_data);
+            }
+        }
+
+        bool IsUnit() const
+        {
+            return (fabs(Mag() - Scalar(ONE)) < Constants<Scalar>::NumTolerance()) ? true : false;
+        }
+    };  //< End of Vector4 SIMD specialisation.
+
 }  //< End of GrapheneMath namespace.
 #endif // __VECTOR4_H__
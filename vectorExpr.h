@@ -0,0 +1,151 @@
+#ifndef __VECTOR_EXPR_H__
+#define __VECTOR_EXPR_H__
+
+#include <cstddef>
+#include "vector3.h"
+#include "vector4.h"
+
+namespace GrapheneMath
+{
+// Opt-in expression templates over Vector3 and Vector4.
+//
+// 'a + b.ScalarMult( s ) - c' builds one const vector temporary per operator.
+// Wrapped with Expr::Ref the same expression builds a tree of references that
+// is evaluated only once, by Eval or Assign, with no intermediate vectors.
+// For a single vector that gains nothing, the inlined temporaries stay in
+// registers anyway, so single vector code (the simulation step, NavLeg)
+// keeps the plain operators.
+//
+// On arrays (Expr::Array leaves) Assign fuses the whole expression into a single
+// pass over the arrays, each element computed with the (SIMD) vector
+// operators, instead of one pass and one intermediate array per operator:
+//
+//   Expr::Assign( &pos[0], count, Expr::Array( &pos[0] ) + Expr::Array( &vel[0] ) * dt );
+//
+// Single vector and array leaves can be mixed, a single vector is then
+// used for every element.
+//
+// Expressions hold references, evaluate them in the statement that builds them.
+// Element i of the destination may alias element i of any operand.
+namespace Expr
+{
+    template <typename Vec>
+    struct ScalarOf;
+
+    template <typename Scalar, bool Simd>
+    struct ScalarOf< Vector3<Scalar, Simd> > { typedef Scalar Type; };
+
+    template <typename Scalar, bool Simd>
+    struct ScalarOf< Vector4<Scalar, Simd> > { typedef Scalar Type; };
+
+    // Base of every expression node, E is the node type itself.
+    // At( i ) evaluates element i, single vector leaves ignore i.
+    template <typename E, typename Vec>
+    struct VecExpr
+    {
+        const E& Self() const { return static_cast<const E&>( *this ); }
+    };
+
+    template <typename Vec>
+    struct VectorRef : public VecExpr< VectorRef<Vec>, Vec >
+    {
+        const Vec& m_vec;
+
+        explicit VectorRef( const Vec& vec ) : m_vec( vec ) {}
+        const Vec& At( size_t ) const { return m_vec; }
+    };
+
+    template <typename Vec>
+    struct ArrayRef : public VecExpr< ArrayRef<Vec>, Vec >
+    {
+        const Vec* m_array;
+
+        explicit ArrayRef( const Vec* array ) : m_array( array ) {}
+        const Vec& At( size_t i ) const { return m_array[i]; }
+    };
+
+    template <typename L, typename R, typename Vec>
+    struct Sum : public VecExpr< Sum<L, R, Vec>, Vec >
+    {
+        const L m_l;
+        const R m_r;
+
+        Sum( const L& l, const R& r ) : m_l( l ), m_r( r ) {}
+        const Vec At( size_t i ) const { return m_l.At( i ) + m_r.At( i ); }
+    };
+
+    template <typename L, typename R, typename Vec>
+    struct Difference : public VecExpr< Difference<L, R, Vec>, Vec >
+    {
+        const L m_l;
+        const R m_r;
+
+        Difference( const L& l, const R& r ) : m_l( l ), m_r( r ) {}
+        const Vec At( size_t i ) const { return m_l.At( i ) - m_r.At( i ); }
+    };
+
+    template <typename E, typename Vec>
+    struct Scaled : public VecExpr< Scaled<E, Vec>, Vec >
+    {
+        typedef typename ScalarOf<Vec>::Type Scalar;
+
+        const E      m_e;
+        const Scalar m_scalar;
+
+        Scaled( const E& e, Scalar scalar ) : m_e( e ), m_scalar( scalar ) {}
+        const Vec At( size_t i ) const { return m_e.At( i ).ScalarMult( m_scalar ); }
+    };
+
+    // Leaves.
+    template <typename Vec>
+    inline VectorRef<Vec> Ref( const Vec& vec ) { return VectorRef<Vec>( vec ); }
+
+    template <typename Vec>
+    inline ArrayRef<Vec> Array( const Vec* array ) { return ArrayRef<Vec>( array ); }
+
+    // Operators.
+    template <typename L, typename R, typename Vec>
+    inline Sum<L, R, Vec> operator+( const VecExpr<L, Vec>& l, const VecExpr<R, Vec>& r )
+    {
+        return Sum<L, R, Vec>( l.Self(), r.Self() );
+    }
+
+    template <typename L, typename R, typename Vec>
+    inline Difference<L, R, Vec> operator-( const VecExpr<L, Vec>& l, const VecExpr<R, Vec>& r )
+    {
+        return Difference<L, R, Vec>( l.Self(), r.Self() );
+    }
+
+    template <typename E, typename Vec>
+    inline Scaled<E, Vec> operator*( const VecExpr<E, Vec>& e, typename ScalarOf<Vec>::Type scalar )
+    {
+        return Scaled<E, Vec>( e.Self(), scalar );
+    }
+
+    template <typename E, typename Vec>
+    inline Scaled<E, Vec> operator*( typename ScalarOf<Vec>::Type scalar, const VecExpr<E, Vec>& e )
+    {
+        return Scaled<E, Vec>( e.Self(), scalar );
+    }
+
+    // Evaluation of a single vector expression.
+    template <typename E, typename Vec>
+    inline const Vec Eval( const VecExpr<E, Vec>& e )
+    {
+        return e.Self().At( 0 );
+    }
+
+    // Evaluation of an array expression into dst[0, count), one pass.
+    template <typename E, typename Vec>
+    inline void Assign( Vec* dst, size_t count, const VecExpr<E, Vec>& e )
+    {
+        const E& expr = e.Self();
+        for( size_t i = 0; i < count; ++i )
+        {
+            dst[i] = expr.At( i );
+        }
+    }
+
+}  //< End of Expr namespace.
+}  //< End of GrapheneMath namespace.
+#endif // __VECTOR_EXPR_H__
@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "windCorrectionTable.h"
+
+const double   WindCorrectionTable::MAX_RATIO_LIMIT = 0.999;
+const char     WindCorrectionTable::c_magic[ 8 ] = { 'N', 'A', 'V', 'E', 'X', 'W', 'C', 'T' };
+const uint32_t WindCorrectionTable::c_version = 2;
+
+WindCorrectionTable::WindCorrectionTable()
+    : m_angleSteps( 0 )
+    , m_ratioSteps( 0 )
+    , m_maxRatio( 0.0 )
+    , m_angleScale( 0.0 )
+    , m_ratioScale( 0.0 )
+    , m_cells( NULL )
+    , m_patches( NULL )
+    , m_mapping( NULL )
+    , m_mappingSize( 0 )
+{
+    m_maxWcaErrorDeg[ eBilinear ] = m_maxWcaErrorDeg[ eCubic ] = 0.0;
+    m_maxGsFactorError[ eBilinear ] = m_maxGsFactorError[ eCubic ] = 0.0;
+}
+
+WindCorrectionTable::~WindCorrectionTable()
+{
+    Release();
+}
+
+void WindCorrectionTable::Release()
+{
+    if( m_mapping )
+    {
+        munmap( m_mapping, m_mappingSize );
+        m_mapping = NULL;
+        m_mappingSize = 0;
+    }
+
+    m_storage.clear();
+    m_patchStorage.clear();
+    m_cells = NULL;
+    m_patches = NULL;
+    m_angleSteps = 0;
+    m_ratioSteps = 0;
+}
+
+void WindCorrectionTable::UpdateScales()
+{
+    m_angleScale = m_angleSteps / TriangleOfVelocitiesSolver::THREE_SIXTY_DEG;
+    m_ratioScale = m_ratioSteps / m_maxRatio;
+}
+
+// Exact answer from the solver kernel for a triangle with TAS = 1 and TR = 0.
+void WindCorrectionTable::Exact( double relWindDeg, double ratio, double& WCA, double& GSFactor )
+{
+    double TR  = 0.0;
+    double TAS = 1.0;
+    double W   = relWindDeg;
+    double V   = ratio;
+    double HDG = 0.0;
+
+    TriangleKernel< TriangleOfVelocitiesSolver::eFindHdgGs >::solve( TR, TAS, W, V, HDG, GSFactor );
+
+    WCA = ( HDG > TriangleOfVelocitiesSolver::ONE_EIGHTY_DEG ) ? ( HDG - TriangleOfVelocitiesSolver::THREE_SIXTY_DEG ) : HDG;
+}
+
+// With TAS = 1, TR = 0, relative wind a and ratio r:
+//   WCA      = asin( r sin a )
+//   GSFactor = q - r cos a,  q = sqrt( 1 - r^2 sin^2 a ) = cos WCA
+// values from the kernel, derivatives from the closed form.
+void WindCorrectionTable::Derivatives( double relWindDeg, double ratio, double WCA[ 4 ], double GSFactor[ 4 ] )
+{
+    const double degToRad = TriangleOfVelocitiesSolver::DEG_TO_RAD;
+    const double radToDeg = TriangleOfVelocitiesSolver::RAD_TO_DEG;
+
+    Exact( relWindDeg, ratio, WCA[ 0 ], GSFactor[ 0 ] );
+
+    const double s  = sin( relWindDeg * degToRad );
+    const double c  = cos( relWindDeg * degToRad );
+    const double q  = sqrt( 1.0 - ratio * ratio * s * s );
+    const double q3 = q * q * q;
+
+    WCA[ 1 ] = ratio * c / q;           //< DEG per DEG
+    WCA[ 2 ] = radToDeg * s / q;
+    WCA[ 3 ] = c / q3;
+
+    GSFactor[ 1 ] = degToRad * ratio * s * ( 1.0 - ratio * c / q );
+    GSFactor[ 2 ] = -ratio * s * s / q - c;
+    GSFactor[ 3 ] = degToRad * s * ( 1.0 - ratio * c * ( 2.0 - ratio * ratio * s * s ) / q3 );
+}
+
+// Bicubic Hermite patch over one cell from value, d/du, d/dv and d2/du dv at
+// its corners f00 (u = 0, v = 0), f10, f01 and f11, derivatives per grid unit
+// after scaling by the cell size du, dv.
+static void HermitePatch( const double* f00, const double* f10, const double* f01, const double* f11,
+                          double du, double dv, float* coeffs )
+{
+    const double F[ 4 ][ 4 ] =
+    {
+        { f00[0],           f01[0],           f00[2] * dv,           f01[2] * dv },
+        { f10[0],           f11[0],           f10[2] * dv,           f11[2] * dv },
+        { f00[1] * du,      f01[1] * du,      f00[3] * du * dv,      f01[3] * du * dv },
+        { f10[1] * du,      f11[1] * du,      f10[3] * du * dv,      f11[3] * du * dv }
+    };
+
+    static const double M[ 4 ][ 4 ] =
+    {
+        {  1.0,  0.0,  0.0,  0.0 },
+        {  0.0,  0.0,  1.0,  0.0 },
+        { -3.0,  3.0, -2.0, -1.0 },
+        {  2.0, -2.0,  1.0,  1.0 }
+    };
+
+    // coeffs = M F M^T
+    double MF[ 4 ][ 4 ];
+    for( int i = 0; i < 4; ++i )
+    {
+        for( int j = 0; j < 4; ++j )
+        {
+            MF[ i ][ j ] = M[ i ][ 0 ] * F[ 0 ][ j ] + M[ i ][ 1 ] * F[ 1 ][ j ] +
+                           M[ i ][ 2 ] * F[ 2 ][ j ] + M[ i ][ 3 ] * F[ 3 ][ j ];
+        }
+    }
+
+    for( int i = 0; i < 4; ++i )
+    {
+        for( int j = 0; j < 4; ++j )
+        {
+            coeffs[ 4 * i + j ] = static_cast<float>( MF[ i ][ 0 ] * M[ j ][ 0 ] + MF[ i ][ 1 ] * M[ j ][ 1 ] +
+                                                      MF[ i ][ 2 ] * M[ j ][ 2 ] + MF[ i ][ 3 ] * M[ j ][ 3 ] );
+        }
+    }
+}
+
+void WindCorrectionTable::Build( uint32_t angleSteps, uint32_t ratioSteps, double maxRatio )
+{
+    assert( angleSteps > 0 && ratioSteps > 0 );
+    assert( maxRatio > 0.0 );
+
+    Release();
+
+    m_angleSteps = angleSteps;
+    m_ratioSteps = ratioSteps;
+    m_maxRatio   = std::min( maxRatio, MAX_RATIO_LIMIT );
+    UpdateScales();
+
+    const size_t numNodes = ( static_cast<size_t>( angleSteps ) + 1 ) * ( ratioSteps + 1 );
+    m_storage.resize( numNodes );
+
+    // Value and derivatives of WCA (0-3) and GSFactor (4-7) per node.
+    std::vector<double> nodes( numNodes * 8 );
+
+    for( uint32_t r = 0; r <= ratioSteps; ++r )
+    {
+        const double ratio = m_maxRatio * r / ratioSteps;
+
+        for( uint32_t a = 0; a <= angleSteps; ++a )
+        {
+            // Last column repeats the first one.
+            const double relWindDeg = TriangleOfVelocitiesSolver::THREE_SIXTY_DEG * ( a % angleSteps ) / angleSteps;
+
+            const size_t idx = static_cast<size_t>( r ) * ( angleSteps + 1 ) + a;
+            double* const node = &nodes[ idx * 8 ];
+            Derivatives( relWindDeg, ratio, node, node + 4 );
+
+            Cell& cell = m_storage[ idx ];
+            cell.WCA      = static_cast<float>( node[ 0 ] );
+            cell.GSFactor = static_cast<float>( node[ 4 ] );
+        }
+    }
+
+    const double angleStepDeg = TriangleOfVelocitiesSolver::THREE_SIXTY_DEG / angleSteps;
+    const double ratioStep    = m_maxRatio / ratioSteps;
+
+    m_patchStorage.resize( static_cast<size_t>( angleSteps ) * ratioSteps );
+
+    for( uint32_t r = 0; r < ratioSteps; ++r )
+    {
+        for( uint32_t a = 0; a < angleSteps; ++a )
+        {
+            const double* const n00 = &nodes[ ( static_cast<size_t>( r ) * ( angleSteps + 1 ) + a ) * 8 ];
+            const double* const n10 = n00 + 8;
+            const double* const n01 = n00 + ( angleSteps + 1 ) * 8;
+            const double* const n11 = n01 + 8;
+
+            Patch& patch = m_patchStorage[ static_cast<size_t>( r ) * angleSteps + a ];
+            HermitePatch( n00, n10, n01, n11, angleStepDeg, ratioStep, patch.WCA );
+            HermitePatch( n00 + 4, n10 + 4, n01 + 4, n11 + 4, angleStepDeg, ratioStep, patch.GSFactor );
+        }
+    }
+
+    m_cells   = &m_storage[ 0 ];
+    m_patches = &m_patchStorage[ 0 ];
+
+    const uint32_t numRandomSamples = 100000;
+    MeasureError( numRandomSamples, eBilinear, m_maxWcaErrorDeg[ eBilinear ], m_maxGsFactorError[ eBilinear ] );
+    MeasureError( numRandomSamples, eCubic, m_maxWcaErrorDeg[ eCubic ], m_maxGsFactorError[ eCubic ] );
+}
+
+bool WindCorrectionTable::Save( const char* fileName ) const
+{
+    if( !IsValid() )
+    {
+        return false;
+    }
+
+    FileHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, c_magic, sizeof( c_magic ) );
+    header.version    = c_version;
+    header.angleSteps = m_angleSteps;
+    header.ratioSteps = m_ratioSteps;
+    header.maxRatio   = m_maxRatio;
+    for( int i = eBilinear; i <= eCubic; ++i )
+    {
+        header.maxWcaErrorDeg[ i ]   = m_maxWcaErrorDeg[ i ];
+        header.maxGsFactorError[ i ] = m_maxGsFactorError[ i ];
+    }
+
+    FILE* file = fopen( fileName, "wb" );
+    if( !file )
+    {
+        return false;
+    }
+
+    const size_t numCells   = ( static_cast<size_t>( m_angleSteps ) + 1 ) * ( m_ratioSteps + 1 );
+    const size_t numPatches = static_cast<size_t>( m_angleSteps ) * m_ratioSteps;
+    const bool written = ( fwrite( &header, sizeof( header ), 1, file ) == 1 ) &&
+                         ( fwrite( m_cells, sizeof( Cell ), numCells, file ) == numCells ) &&
+                         ( fwrite( m_patches, sizeof( Patch ), numPatches, file ) == numPatches );
+
+    return ( fclose( file ) == 0 ) && written;
+}
+
+bool WindCorrectionTable::Map( const char* fileName )
+{
+    Release();
+
+    const int fd = open( fileName, O_RDONLY );
+    if( fd < 0 )
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    if( fstat( fd, &fileStat ) != 0 || static_cast<size_t>( fileStat.st_size ) < sizeof( FileHeader ) )
+    {
+        close( fd );
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>( fileStat.st_size );
+    void* const mapping = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd ); //< the mapping stays valid
+
+    if( mapping == MAP_FAILED )
+    {
+        return false;
+    }
+
+    const FileHeader& header = *static_cast<const FileHeader*>( mapping );
+
+    // Every node takes space in the file, which bounds the step counts before
+    // they are multiplied, a corrupt header can't wrap the size check.
+    const size_t maxNodes   = ( size - sizeof( FileHeader ) ) / sizeof( Cell );
+    const bool   stepsValid = header.angleSteps > 0 && header.ratioSteps > 0 &&
+                              static_cast<size_t>( header.angleSteps ) + 1 <=
+                              maxNodes / ( static_cast<size_t>( header.ratioSteps ) + 1 );
+    const size_t numCells   = stepsValid ? ( static_cast<size_t>( header.angleSteps ) + 1 ) *
+                                           ( static_cast<size_t>( header.ratioSteps ) + 1 ) : 0;
+    const size_t numPatches = stepsValid ? static_cast<size_t>( header.angleSteps ) * header.ratioSteps : 0;
+
+    // UpdateScales() divides by maxRatio, also rejects NaN.
+    const bool ratioValid = header.maxRatio > 0.0 && header.maxRatio <= MAX_RATIO_LIMIT;
+
+    if( memcmp( header.magic, c_magic, sizeof( c_magic ) ) != 0 ||
+        header.version != c_version ||
+        !stepsValid || !ratioValid ||
+        size != sizeof( FileHeader ) + numCells * sizeof( Cell ) + numPatches * sizeof( Patch ) )
+    {
+        munmap( mapping, size );
+        return false;
+    }
+
+    m_mapping     = mapping;
+    m_mappingSize = size;
+    m_angleSteps  = header.angleSteps;
+    m_ratioSteps  = header.ratioSteps;
+    m_maxRatio    = header.maxRatio;
+    UpdateScales();
+    for( int i = eBilinear; i <= eCubic; ++i )
+    {
+        m_maxWcaErrorDeg[ i ]   = header.maxWcaErrorDeg[ i ];
+        m_maxGsFactorError[ i ] = header.maxGsFactorError[ i ];
+    }
+    m_cells   = reinterpret_cast<const Cell*>( static_cast<const char*>( mapping ) + sizeof( FileHeader ) );
+    m_patches = reinterpret_cast<const Patch*>( m_cells + numCells );
+
+    return true;
+}
+
+bool WindCorrectionTable::Lookup( double TR, double TAS, double W, double V,
+                                  double& HDG, double& GS,
+                                  Interpolation interp ) const
+{
+    assert( IsValid() );
+
+    // Also rejects TAS <= 0 and NaN.
+    const double ratio = V / TAS;
+    if( !( TAS > 0.0 && ratio >= 0.0 && ratio <= m_maxRatio ) )
+    {
+        return false;
+    }
+
+    // Directions are expected in [0, 360) DEG like everywhere else in the solver.
+    const double relWindDeg = TriangleKernelBase::wrap360( W - TR );
+
+    double WCA, GSFactor;
+    Interpolate( relWindDeg, ratio, interp, WCA, GSFactor );
+
+    HDG = TriangleKernelBase::wrap360( TR + WCA );
+    GS  = TAS * GSFactor;
+
+    return true;
+}
+
+// Bicubic patch at u, v from the powers of v, the four rows are independent.
+static inline double EvalPatch( const float* c, double u, double v, double v2, double v3 )
+{
+    const double p0 = c[ 0 ]  + c[ 1 ] * v  + c[ 2 ] * v2  + c[ 3 ] * v3;
+    const double p1 = c[ 4 ]  + c[ 5 ] * v  + c[ 6 ] * v2  + c[ 7 ] * v3;
+    const double p2 = c[ 8 ]  + c[ 9 ] * v  + c[ 10 ] * v2 + c[ 11 ] * v3;
+    const double p3 = c[ 12 ] + c[ 13 ] * v + c[ 14 ] * v2 + c[ 15 ] * v3;
+    return p0 + u * ( p1 + u * ( p2 + u * p3 ) );
+}
+
+void WindCorrectionTable::Interpolate( double relWindDeg, double ratio, Interpolation interp,
+                                       double& WCA, double& GSFactor ) const
+{
+    const double a = relWindDeg * m_angleScale;
+    const double r = ratio * m_ratioScale;
+
+    const uint32_t ia = std::min( static_cast<uint32_t>( a ), m_angleSteps - 1 );
+    const uint32_t ir = std::min( static_cast<uint32_t>( r ), m_ratioSteps - 1 );
+    const double   fa = a - ia;
+    const double   fr = r - ir;
+
+    if( interp == eBilinear )
+    {
+        const Cell& c00 = At( ia,     ir );
+        const Cell& c10 = At( ia + 1, ir );
+        const Cell& c01 = At( ia,     ir + 1 );
+        const Cell& c11 = At( ia + 1, ir + 1 );
+
+        const double WCA0 = c00.WCA + fa * ( c10.WCA - c00.WCA );
+        const double WCA1 = c01.WCA + fa * ( c11.WCA - c01.WCA );
+        const double GS0  = c00.GSFactor + fa * ( c10.GSFactor - c00.GSFactor );
+        const double GS1  = c01.GSFactor + fa * ( c11.GSFactor - c01.GSFactor );
+
+        WCA      = WCA0 + fr * ( WCA1 - WCA0 );
+        GSFactor = GS0 + fr * ( GS1 - GS0 );
+        return;
+    }
+
+    const Patch& patch = m_patches[ ir * m_angleSteps + ia ];
+    const double fr2   = fr * fr;
+    const double fr3   = fr2 * fr;
+    WCA      = EvalPatch( patch.WCA, fa, fr, fr2, fr3 );
+    GSFactor = EvalPatch( patch.GSFactor, fa, fr, fr2, fr3 );
+}
+
+void WindCorrectionTable::MeasureError( uint32_t numRandomSamples,
+                                        Interpolation interp,
+                                        double& maxWcaErrorDeg,
+                                        double& maxGsFactorError ) const
+{
+    assert( IsValid() );
+
+    maxWcaErrorDeg   = 0.0;
+    maxGsFactorError = 0.0;
+
+    const double angleStepDeg = TriangleOfVelocitiesSolver::THREE_SIXTY_DEG / m_angleSteps;
+    const double ratioStep    = m_maxRatio / m_ratioSteps;
+    const uint32_t numCentres = m_angleSteps * m_ratioSteps;
+
+    uint32_t seed = 12345u; //< fixed seed, reproducible error figures
+
+    for( uint32_t i = 0; i < numCentres + numRandomSamples; ++i )
+    {
+        double relWindDeg, ratio;
+
+        if( i < numCentres )
+        {
+            // Cell centres are the worst case for linear interpolation.
+            relWindDeg = ( ( i % m_angleSteps ) + 0.5 ) * angleStepDeg;
+            ratio      = ( ( i / m_angleSteps ) + 0.5 ) * ratioStep;
+        }
+        else
+        {
+            seed = seed * 1664525u + 1013904223u;
+            relWindDeg = TriangleOfVelocitiesSolver::THREE_SIXTY_DEG * ( seed >> 8 ) / 16777216.0;
+            seed = seed * 1664525u + 1013904223u;
+            ratio      = m_maxRatio * ( seed >> 8 ) / 16777216.0;
+        }
+
+        double WCA, GSFactor, exactWCA, exactGSFactor;
+        Interpolate( relWindDeg, ratio, interp, WCA, GSFactor );
+        Exact( relWindDeg, ratio, exactWCA, exactGSFactor );
+
+        maxWcaErrorDeg   = std::max( maxWcaErrorDeg, fabs( WCA - exactWCA ) );
+        maxGsFactorError = std::max( maxGsFactorError, fabs( GSFactor - exactGSFactor ) );
+    }
+}
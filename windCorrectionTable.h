@@ -0,0 +1,149 @@
+#ifndef __WIND_CORRECTION_TABLE_H__
+#define __WIND_CORRECTION_TABLE_H__
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "triangle.h"
+
+// Precomputed W/V + TR + TAS -> HDG/GS answers for interactive planning.
+//
+// The triangle scales with TAS, so it only depends on two values:
+// the relative wind angle <)W,TR (W - TR, [0, 360) DEG) and the ratio V/TAS.
+// The table stores for a grid of both the wind correction angle
+// WCA = HDG - TR (DEG) and the factor GS/TAS, and answers queries by bilinear
+// interpolation or by a bicubic patch instead of sin/asin/cos per query.
+// The patches are Hermite, built per cell from the closed form derivatives of
+// WCA = asin( V/TAS sin( W - TR ) ), so a cubic lookup evaluates one patch
+// and needs no neighbouring cells. A patch takes the memory of 16 nodes, a
+// cubic table 4x coarser in both directions is still far more accurate.
+//
+// Only V/TAS in [0, maxRatio] with maxRatio < 1 is covered (single solution,
+// TAS > V). Lookup() returns false outside of it and the exact solver has to
+// be used instead.
+//
+// A built table can be saved and later memory-mapped read only, which makes
+// startup cost independent of the table resolution.
+class WindCorrectionTable
+{
+public:
+    enum Interpolation : uint8_t
+    {
+        eBilinear = 0,
+        eCubic
+    };
+
+    static const double MAX_RATIO_LIMIT;
+
+    WindCorrectionTable();
+    ~WindCorrectionTable();
+
+    // Fills the table from the exact solver kernel. The grid has angleSteps
+    // cells over 360 DEG and ratioSteps cells over [0, maxRatio].
+    // The maximum interpolation error is measured and stored with the table.
+    void Build( uint32_t angleSteps, uint32_t ratioSteps, double maxRatio );
+
+    // Writes a built or mapped table to disk.
+    bool Save( const char* fileName ) const;
+
+    // Memory-maps a table written by Save(). Returns false if the file is
+    // missing or isn't a table of this version.
+    bool Map( const char* fileName );
+
+    // Frees the table (built or mapped).
+    void Release();
+
+    bool IsValid() const { return m_cells != NULL; }
+
+    uint32_t GetAngleSteps() const { return m_angleSteps; }
+    uint32_t GetRatioSteps() const { return m_ratioSteps; }
+    double   GetMaxRatio() const { return m_maxRatio; }
+
+    // Maximum error against the exact solver, measured at build time.
+    double GetMaxWcaErrorDeg( Interpolation interp ) const { return m_maxWcaErrorDeg[ interp ]; }
+    double GetMaxGsFactorError( Interpolation interp ) const { return m_maxGsFactorError[ interp ]; }
+
+    // Solves W/V + TR + TAS -> HDG/GS from the table, directions in [0, 360) DEG.
+    // Returns false, leaving HDG and GS untouched, if V/TAS is outside of the table.
+    bool Lookup( double TR, double TAS, double W, double V,
+                 double& HDG, double& GS,
+                 Interpolation interp = eBilinear ) const;
+
+    // Measures the maximum error against the exact solver at every cell centre
+    // and at 'numRandomSamples' pseudo random points of the table domain.
+    void MeasureError( uint32_t numRandomSamples,
+                       Interpolation interp,
+                       double& maxWcaErrorDeg,
+                       double& maxGsFactorError ) const;
+
+private:
+    // On-disk header, followed by the cells and the patches.
+    struct FileHeader
+    {
+        char     magic[ 8 ];
+        uint32_t version;
+        uint32_t angleSteps;
+        uint32_t ratioSteps;
+        uint32_t reserved;
+        double   maxRatio;
+        double   maxWcaErrorDeg[ 2 ];
+        double   maxGsFactorError[ 2 ];
+    };
+
+    // One grid node.
+    struct Cell
+    {
+        float WCA;      //< wind correction angle (DEG)
+        float GSFactor; //< GS / TAS
+    };
+
+    // Bicubic coefficients of one cell, value = sum c[ 4i + j ] u^i v^j with
+    // u, v the position in the cell along the angle and the ratio.
+    struct Patch
+    {
+        float WCA[ 16 ];
+        float GSFactor[ 16 ];
+    };
+
+    static const char     c_magic[ 8 ];
+    static const uint32_t c_version;
+
+    uint32_t           m_angleSteps;
+    uint32_t           m_ratioSteps;
+    double             m_maxRatio;
+    double             m_angleScale;  //< grid cells per DEG
+    double             m_ratioScale;  //< grid cells per unit of V/TAS
+    double             m_maxWcaErrorDeg[ 2 ];
+    double             m_maxGsFactorError[ 2 ];
+
+    std::vector<Cell>  m_storage;       //< cells of a built table
+    std::vector<Patch> m_patchStorage;  //< patches of a built table
+    const Cell*        m_cells;         //< built or mapped cells
+    const Patch*       m_patches;       //< built or mapped patches, angleSteps x ratioSteps
+    void*              m_mapping;       //< whole mapped file
+    size_t             m_mappingSize;
+
+    WindCorrectionTable( const WindCorrectionTable& );             //< non copyable
+    WindCorrectionTable& operator=( const WindCorrectionTable& );
+
+    // Grid has (angleSteps + 1) x (ratioSteps + 1) nodes, the last angle column
+    // repeats the first one so that interpolation never wraps.
+    inline const Cell& At( uint32_t angleIdx, uint32_t ratioIdx ) const
+    {
+        return m_cells[ ratioIdx * ( m_angleSteps + 1 ) + angleIdx ];
+    }
+
+    void UpdateScales();
+
+    void Interpolate( double relWindDeg, double ratio, Interpolation interp,
+                      double& WCA, double& GSFactor ) const;
+
+    static void Exact( double relWindDeg, double ratio, double& WCA, double& GSFactor );
+
+    // Value, d/dangle (per DEG), d/dratio and d2/dangle dratio of WCA and GSFactor.
+    static void Derivatives( double relWindDeg, double ratio, double WCA[ 4 ], double GSFactor[ 4 ] );
+};
+
+#endif //__WIND_CORRECTION_TABLE_H__
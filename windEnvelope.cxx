@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#include "windEnvelope.h"
+
+// 8 rows of 360 directions, HDG and GS: ~46 KB of output per chunk.
+const size_t WindEnvelopeSweep::c_rowsPerChunk = 8;
+
+// Smallest GS (kts) that makes headway, below it is the rounding of a zero GS
+// (wind speed equal to TAS, ahead of the beam).
+static const double c_minGS = 1E-9;
+
+WindEnvelopeSweep::WindEnvelopeSweep( double dirStepDeg, double speedStepKt, double maxSpeedKt )
+    : m_dirStepDeg( dirStepDeg )
+    , m_speedStepKt( speedStepKt )
+    , m_numDirs( 0 )
+    , m_numSpeeds( 0 )
+    , m_numThreads( 0 )
+{
+    assert( dirStepDeg > 0.0 && speedStepKt > 0.0 );
+    assert( maxSpeedKt >= speedStepKt );
+
+    m_numDirs   = static_cast<size_t>( ceil( TriangleOfVelocitiesSolver::THREE_SIXTY_DEG / dirStepDeg - 1E-9 ) );
+    m_numSpeeds = static_cast<size_t>( floor( maxSpeedKt / speedStepKt + 1E-9 ) );
+}
+
+void WindEnvelopeSweep::Run( const double* TR, const double* TAS, size_t numLegs )
+{
+    m_TR.assign( TR, TR + numLegs );
+    m_TAS.assign( TAS, TAS + numLegs );
+    m_HDG.resize( numLegs * GetGridSize() );
+    m_GS.resize( numLegs * GetGridSize() );
+    m_rowSummaries.resize( numLegs * m_numSpeeds );
+    m_summaries.resize( numLegs );
+
+    const size_t numRows   = numLegs * m_numSpeeds;
+    const size_t numChunks = ( numRows + c_rowsPerChunk - 1 ) / c_rowsPerChunk;
+
+    unsigned numThreads = m_numThreads ? m_numThreads : std::thread::hardware_concurrency();
+    numThreads = std::max( 1u, std::min( numThreads, static_cast<unsigned>( numChunks ) ) );
+
+    std::atomic<size_t> nextChunk( 0 );
+    std::vector<std::thread> workers;
+    for( unsigned i = 1; i < numThreads; ++i ) {
+        workers.push_back( std::thread( &WindEnvelopeSweep::Work, this, std::ref( nextChunk ) ) );
+    }
+    Work( nextChunk ); //< the calling thread works too
+
+    for( size_t i = 0; i < workers.size(); ++i ) {
+        workers[i].join();
+    }
+
+    for( size_t leg = 0; leg < numLegs; ++leg )
+    {
+        WindEnvelopeSummary& summary = m_summaries[ leg ];
+        summary = m_rowSummaries[ leg * m_numSpeeds ];
+        for( size_t row = 1; row < m_numSpeeds; ++row ) {
+            Merge( summary, m_rowSummaries[ leg * m_numSpeeds + row ] );
+        }
+    }
+}
+
+void WindEnvelopeSweep::Work( std::atomic<size_t>& nextChunk )
+{
+    const size_t numRows = m_summaries.size() * m_numSpeeds;
+
+    for( ;; )
+    {
+        const size_t firstRow = ( nextChunk++ ) * c_rowsPerChunk;
+        if( firstRow >= numRows ) {
+            return;
+        }
+        SolveRows( firstRow, std::min( firstRow + c_rowsPerChunk, numRows ) );
+    }
+}
+
+void WindEnvelopeSweep::SolveRows( size_t firstRow, size_t endRow )
+{
+    // Inputs of one row, the outputs are written straight into the grid.
+    std::vector<double> TR( m_numDirs ), TAS( m_numDirs ), W( m_numDirs ), V( m_numDirs );
+    std::vector<double> sinRelWind( m_numDirs ); //< crosswind per kt of wind, of the leg below
+    size_t sinLeg = m_summaries.size();
+
+    for( size_t dirIdx = 0; dirIdx < m_numDirs; ++dirIdx ) {
+        W[ dirIdx ] = GetDir( dirIdx );
+    }
+
+    TriangleOfVelocitiesSoA batch;
+    batch.TR    = &TR[0];
+    batch.TAS   = &TAS[0];
+    batch.W     = &W[0];
+    batch.V     = &V[0];
+    batch.count = m_numDirs;
+
+    for( size_t row = firstRow; row < endRow; ++row )
+    {
+        const size_t leg      = row / m_numSpeeds;
+        const size_t speedIdx = row % m_numSpeeds;
+        const double speed    = GetSpeed( speedIdx );
+
+        std::fill( TR.begin(), TR.end(), m_TR[ leg ] );
+        std::fill( TAS.begin(), TAS.end(), m_TAS[ leg ] );
+        std::fill( V.begin(), V.end(), speed );
+
+        batch.HDG = &m_HDG[ row * m_numDirs ];
+        batch.GS  = &m_GS[ row * m_numDirs ];
+        // Exact trigonometry, not the SSE polynomials: near the tangent (crosswind
+        // equal to TAS) their 1e-6 error in sin( WCA ) is ~0.1 kts of GS, which
+        // would decide whether a wind is feasible.
+        TriangleOfVelocitiesSolver::solveBatch< TriangleOfVelocitiesSolver::eFindHdgGs, GRAPHENE_FAST_TRIG >( batch );
+
+        if( leg != sinLeg )
+        {
+            const double TR_RAD = m_TR[ leg ] * Constants<double>::DegToRad();
+            for( size_t dirIdx = 0; dirIdx < m_numDirs; ++dirIdx ) {
+                sinRelWind[ dirIdx ] = Trig<double>::Sin( W[ dirIdx ] * Constants<double>::DegToRad() - TR_RAD );
+            }
+            sinLeg = leg;
+        }
+
+        WindEnvelopeSummary& summary = m_rowSummaries[ row ];
+        summary = WindEnvelopeSummary();
+
+        for( size_t dirIdx = 0; dirIdx < m_numDirs; ++dirIdx )
+        {
+            // The batch kernel clamps the crosswind to TAS and solves anyway.
+            const double GS = batch.GS[ dirIdx ];
+            if( fabs( speed * sinRelWind[ dirIdx ] ) > m_TAS[ leg ] || !( GS > c_minGS ) )
+            {
+                batch.HDG[ dirIdx ] = std::numeric_limits<double>::quiet_NaN();
+                batch.GS[ dirIdx ]  = std::numeric_limits<double>::quiet_NaN();
+                ++summary.numInfeasible;
+                continue;
+            }
+
+            double drift = m_TR[ leg ] - batch.HDG[ dirIdx ];
+            drift = ( drift > TriangleOfVelocitiesSolver::ONE_EIGHTY_DEG ) ? ( drift - TriangleOfVelocitiesSolver::THREE_SIXTY_DEG ) : drift;
+            drift = ( drift < -TriangleOfVelocitiesSolver::ONE_EIGHTY_DEG ) ? ( drift + TriangleOfVelocitiesSolver::THREE_SIXTY_DEG ) : drift;
+
+            const bool first = ( summary.numFeasible++ == 0 );
+            if( first || GS < summary.minGS )
+            {
+                summary.minGS   = GS;
+                summary.minGS_W = W[ dirIdx ];
+                summary.minGS_V = speed;
+            }
+            if( first || GS > summary.maxGS )
+            {
+                summary.maxGS   = GS;
+                summary.maxGS_W = W[ dirIdx ];
+                summary.maxGS_V = speed;
+            }
+            if( first || fabs( drift ) > fabs( summary.maxDrift ) )
+            {
+                summary.maxDrift   = drift;
+                summary.maxDrift_W = W[ dirIdx ];
+                summary.maxDrift_V = speed;
+            }
+        }
+        summary.solvable = ( summary.numInfeasible == 0 );
+    }
+}
+
+void WindEnvelopeSweep::Merge( WindEnvelopeSummary& summary, const WindEnvelopeSummary& row )
+{
+    summary.numInfeasible += row.numInfeasible;
+    summary.solvable = summary.solvable && row.solvable;
+
+    if( row.numFeasible == 0 ) {
+        return;
+    }
+    if( summary.numFeasible == 0 )
+    {
+        const size_t numInfeasible = summary.numInfeasible;
+        const bool   solvable      = summary.solvable;
+        summary = row;
+        summary.numInfeasible = numInfeasible;
+        summary.solvable      = solvable;
+        return;
+    }
+    summary.numFeasible += row.numFeasible;
+
+    if( row.minGS < summary.minGS )
+    {
+        summary.minGS   = row.minGS;
+        summary.minGS_W = row.minGS_W;
+        summary.minGS_V = row.minGS_V;
+    }
+    if( row.maxGS > summary.maxGS )
+    {
+        summary.maxGS   = row.maxGS;
+        summary.maxGS_W = row.maxGS_W;
+        summary.maxGS_V = row.maxGS_V;
+    }
+    if( fabs( row.maxDrift ) > fabs( summary.maxDrift ) )
+    {
+        summary.maxDrift   = row.maxDrift;
+        summary.maxDrift_W = row.maxDrift_W;
+        summary.maxDrift_V = row.maxDrift_V;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef __WIND_ENVELOPE_H__
+#define __WIND_ENVELOPE_H__
+
+#include <assert.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "triangle.h"
+
+// Worst case of one leg over the whole wind grid.
+// Drift is TR - HDG (DEG, positive when the wind drifts the aeroplane to the right).
+// Only feasible winds count: a crosswind component above TAS or a headwind
+// leaving no GS can't be flown and is counted in numInfeasible instead.
+// The GS and drift fields stay 0 when no wind of the grid is feasible.
+struct WindEnvelopeSummary
+{
+    double minGS;      //< kts
+    double minGS_W;    //< wind of the minimum GS (DEG T, FROM)
+    double minGS_V;    //< kts
+    double maxGS;
+    double maxGS_W;
+    double maxGS_V;
+    double maxDrift;   //< largest |drift| (DEG)
+    double maxDrift_W;
+    double maxDrift_V;
+    size_t numFeasible;
+    size_t numInfeasible;
+    bool   solvable;   //< false if some wind of the grid is infeasible
+
+    WindEnvelopeSummary()
+        : minGS( 0.0 ), minGS_W( 0.0 ), minGS_V( 0.0 )
+        , maxGS( 0.0 ), maxGS_W( 0.0 ), maxGS_V( 0.0 )
+        , maxDrift( 0.0 ), maxDrift_W( 0.0 ), maxDrift_V( 0.0 )
+        , numFeasible( 0 ), numInfeasible( 0 )
+        , solvable( true )
+    {}
+};
+
+// HDG/GS envelope of planned legs over a grid of winds, for pre-briefing worst cases.
+//
+// Every leg (TR, TAS) is solved for wind directions 0, dirStep, ... < 360 DEG
+// and wind speeds speedStep, 2 speedStep, ... maxSpeed kts.
+// The grid is split into chunks of wind speed rows, which are solved with the
+// silent batch kernel on all cores. The grid of one leg is stored row by row,
+// one row per wind speed, one column per wind direction.
+class WindEnvelopeSweep
+{
+public:
+    WindEnvelopeSweep( double dirStepDeg = 1.0, double speedStepKt = 1.0, double maxSpeedKt = 80.0 );
+
+    // Number of worker threads, 0 (default) uses every core.
+    void SetNumThreads( unsigned numThreads ) { m_numThreads = numThreads; }
+
+    // Sweeps 'numLegs' legs given by their track (DEG T) and true airspeed (kts).
+    // Results of a previous run are replaced.
+    void Run( const double* TR, const double* TAS, size_t numLegs );
+
+    size_t GetNumLegs() const { return m_summaries.size(); }
+    size_t GetNumDirs() const { return m_numDirs; }
+    size_t GetNumSpeeds() const { return m_numSpeeds; }
+
+    // Wind of a grid column / row.
+    double GetDir( size_t dirIdx ) const { return dirIdx * m_dirStepDeg; }
+    double GetSpeed( size_t speedIdx ) const { return ( speedIdx + 1 ) * m_speedStepKt; }
+
+    const WindEnvelopeSummary& GetSummary( size_t leg ) const
+    {
+        assert( leg < m_summaries.size() );
+        return m_summaries[ leg ];
+    }
+
+    // Full grid of one leg, GetNumSpeeds() rows of GetNumDirs() values,
+    // HDG and GS are NaN for the infeasible winds.
+    const double* GetHDG( size_t leg ) const { return &m_HDG[ leg * GetGridSize() ]; }
+    const double* GetGS( size_t leg ) const { return &m_GS[ leg * GetGridSize() ]; }
+
+    // Single grid value of one leg.
+    double GetHDG( size_t leg, size_t speedIdx, size_t dirIdx ) const { return GetHDG( leg )[ speedIdx * m_numDirs + dirIdx ]; }
+    double GetGS( size_t leg, size_t speedIdx, size_t dirIdx ) const { return GetGS( leg )[ speedIdx * m_numDirs + dirIdx ]; }
+
+private:
+    static const size_t c_rowsPerChunk;
+
+    double              m_dirStepDeg;
+    double              m_speedStepKt;
+    size_t              m_numDirs;
+    size_t              m_numSpeeds;
+    unsigned            m_numThreads;
+
+    std::vector<double> m_TR;       //< legs of the current run
+    std::vector<double> m_TAS;
+    std::vector<double> m_HDG;      //< grids of every leg
+    std::vector<double> m_GS;
+    std::vector<WindEnvelopeSummary> m_rowSummaries; //< partial result per grid row
+    std::vector<WindEnvelopeSummary> m_summaries;
+
+    size_t GetGridSize() const { return m_numDirs * m_numSpeeds; }
+
+    // Solves and summarises rows [firstRow, endRow), rows of all legs counted one after another.
+    void SolveRows( size_t firstRow, size_t endRow );
+
+    // Worker loop, takes chunks until none are left.
+    void Work( std::atomic<size_t>& nextChunk );
+
+    static void Merge( WindEnvelopeSummary& summary, const WindEnvelopeSummary& row );
+};
+
+#endif //__WIND_ENVELOPE_H__
@@ -0,0 +1,79 @@
+#include <cmath>
+
+#include "windEstimator.h"
+
+WindEstimator::WindEstimator( double forgetting )
+    : m_forgetting( forgetting )
+{
+    assert( forgetting > 0.0 && forgetting <= 1.0 );
+    Reset();
+}
+
+void WindEstimator::Reset()
+{
+    m_sumWeights   = 0.0;
+    m_sumWeightsSq = 0.0;
+    m_north        = 0.0;
+    m_east         = 0.0;
+    m_sumSqDev     = 0.0;
+    m_numSamples   = 0;
+}
+
+void WindEstimator::AddSample( double HDG, double TAS, double TR, double GS )
+{
+    const double TR_RAD  = TR * TriangleOfVelocitiesSolver::DEG_TO_RAD;
+    const double HDG_RAD = HDG * TriangleOfVelocitiesSolver::DEG_TO_RAD;
+
+    // wind = ground vector - air vector
+    AddWind( GS * cos( TR_RAD ) - TAS * cos( HDG_RAD ),
+             GS * sin( TR_RAD ) - TAS * sin( HDG_RAD ) );
+}
+
+void WindEstimator::AddSamples( const TriangleOfVelocitiesSoA& batch )
+{
+    const double* const TR  = batch.TR;
+    const double* const TAS = batch.TAS;
+    const double* const HDG = batch.HDG;
+    const double* const GS  = batch.GS;
+
+    for( size_t i = 0; i < batch.count; ++i )
+    {
+        AddSample( HDG[i], TAS[i], TR[i], GS[i] );
+    }
+}
+
+bool WindEstimator::GetWind( double& W, double& V ) const
+{
+    if( m_numSamples == 0 ) {
+        return false;
+    }
+
+    V = sqrt( m_north * m_north + m_east * m_east );
+    W = TriangleKernelBase::direction( -m_north, -m_east ); //< direction FROM
+    return true;
+}
+
+const Vector3<float> WindEstimator::GetWV() const
+{
+    return Vector3<float>( static_cast<float>( m_north ), 0.0f, static_cast<float>( m_east ) );
+}
+
+double WindEstimator::GetEffectiveSamples() const
+{
+    return ( m_sumWeightsSq > 0.0 ) ? ( m_sumWeights * m_sumWeights / m_sumWeightsSq ) : 0.0;
+}
+
+double WindEstimator::GetScatterKt() const
+{
+    // Unbiased for reliability weights, equal to the sample variance without forgetting.
+    const double denom = m_sumWeights - m_sumWeightsSq / m_sumWeights;
+    return ( m_numSamples > 1 && denom > 0.0 ) ? sqrt( m_sumSqDev / denom ) : 0.0;
+}
+
+double WindEstimator::GetStdErrorKt() const
+{
+    if( m_numSamples < 2 ) {
+        return HUGE_VAL;
+    }
+    return GetScatterKt() / sqrt( GetEffectiveSamples() );
+}
@@ -0,0 +1,83 @@
+#ifndef __WIND_ESTIMATOR_H__
+#define __WIND_ESTIMATOR_H__
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+
+#include "triangle.h"
+#include "vector3.h"
+
+// Streaming W/V estimate from (HDG, TAS, TR, GS) fixes, the inverse of dead reckoning.
+//
+// Every fix gives one measured wind vector, ground vector - air vector. The
+// least-squares wind for a constant W/V is the (weighted) mean of those vectors,
+// which is updated in O(1) per fix without any allocation.
+// With a forgetting factor below 1 older fixes fade out exponentially, so the
+// estimate follows a changing wind (recursive least squares with forgetting).
+//
+// Fields and units follow TriangleOfVelocities: directions in DEG T, speeds in
+// kts, W is the direction FROM the wind is blowing, as in WV::Set.
+class WindEstimator
+{
+public:
+    // forgetting = 1 weighs every fix equally, 0.99 gives a memory of ~100 fixes.
+    explicit WindEstimator( double forgetting = 1.0 );
+
+    void Reset();
+
+    void AddSample( double HDG, double TAS, double TR, double GS );
+    void AddSample( const TriangleOfVelocities& tov ) { AddSample( tov.HDG, tov.TAS, tov.TR, tov.GS ); }
+
+    // Batch replay of recorded fixes, reads HDG, TAS, TR and GS only.
+    void AddSamples( const TriangleOfVelocitiesSoA& batch );
+
+    // Current estimate, W FROM (DEG T) in [0, 360) and V (kts).
+    // Returns false, leaving W and V untouched, before the first fix.
+    bool GetWind( double& W, double& V ) const;
+
+    // Estimated wind as velocity vector (kts, North x, East z, pointing where
+    // the wind blows), the same as WV::GetWV().
+    const Vector3<float> GetWV() const;
+
+    uint64_t GetNumSamples() const { return m_numSamples; }
+
+    // Number of fixes the estimate effectively rests on (equal to the number of
+    // fixes without forgetting).
+    double GetEffectiveSamples() const;
+
+    // Spread of the measured wind vectors around the estimate (kts, RMS).
+    // Large values mean noisy fixes or a wind that is not constant.
+    double GetScatterKt() const;
+
+    // Confidence metric: 1-sigma uncertainty of the estimated wind vector (kts),
+    // scatter / sqrt( effective samples ). HUGE_VAL with less than two fixes.
+    double GetStdErrorKt() const;
+
+private:
+    double   m_forgetting;
+    double   m_sumWeights;    //< sum of weights
+    double   m_sumWeightsSq;  //< sum of squared weights
+    double   m_north;         //< weighted mean of the wind TO vector (kts)
+    double   m_east;
+    double   m_sumSqDev;      //< weighted sum of squared deviations from the mean
+    uint64_t m_numSamples;
+
+    // Adds one measured wind TO vector (weighted West update).
+    inline void AddWind( double north, double east )
+    {
+        m_sumWeights   = m_forgetting * m_sumWeights + 1.0;
+        m_sumWeightsSq = m_forgetting * m_forgetting * m_sumWeightsSq + 1.0;
+
+        const double devNorth = north - m_north;
+        const double devEast  = east - m_east;
+        const double gain     = 1.0 / m_sumWeights;
+
+        m_north += gain * devNorth;
+        m_east  += gain * devEast;
+        m_sumSqDev = m_forgetting * m_sumSqDev + devNorth * ( north - m_north ) + devEast * ( east - m_east );
+        ++m_numSamples;
+    }
+};
+
+#endif //__WIND_ESTIMATOR_H__
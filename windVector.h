@@ -0,0 +1,40 @@
+#ifndef __WIND_VECTOR_H__
+#define __WIND_VECTOR_H__
+
+// Math
+#include "mathUtils.h"
+#include "vector3.h"
+#include "quat.h"
+
+using namespace GrapheneMath;
+
+// Velocity vectors of the triangle of velocities, free of any rendering code.
+// North is the x axis, East the z axis, directions in DEG T measured clockwise.
+
+// Unit vector pointing to direction 'dirDegT'.
+template <typename Scalar>
+inline const Vector3<Scalar> DirectionVector( Scalar dirDegT )
+{
+    const Vector3<Scalar> dirNorth( Scalar( 1.0 ), Scalar( 0.0 ), Scalar( 0.0 ) ); //< North is x axis.
+    const Vector3<Scalar> downDir( Scalar( 0.0 ), Scalar( -1.0 ), Scalar( 0.0 ) ); //< Clockwise rotation.
+    Quaternion<Scalar> rot;
+    rot.FromAxisAngle( downDir, Deg2Rad( dirDegT ) );
+    return rot.RotateFast( dirNorth );
+}
+
+// Air vector (kts) of an aeroplane flying HDG at TAS.
+template <typename Scalar>
+inline const Vector3<Scalar> AirVector( Scalar HDG, Scalar TAS )
+{
+    return DirectionVector( HDG ).ScalarMult( TAS );
+}
+
+// Wind velocity vector (kts), pointing where the wind blows.
+// The wind is given by the direction FROM it is blowing, as in WV::Set().
+template <typename Scalar>
+inline const Vector3<Scalar> WindVector( Scalar dirFromDegT, Scalar speedKts )
+{
+    return DirectionVector( dirFromDegT ).ScalarMult( -speedKts );
+}
+
+#endif //__WIND_VECTOR_H__
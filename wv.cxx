@@ -12,18 +12,13 @@ WV::WV( const Vector3<float>& drawPosition )
    void WV::Set( float dirFromDegT, float speedKts )
    {
        m_dirFromDegT = dirFromDegT;
-       const Vector3<float> dirNorth( 1.0f, 0.0f, 0.0f ); //< North is x axis.
        const Vector3<float> downDir( 0.0f, -1.0f, 0.0f ); //< Clockwise rotation.
-       Quaternion<float> rot;
-       rot.FromAxisAngle( downDir, Deg2Rad( m_dirFromDegT ) );
-       m_wind = rot.RotateFast( dirNorth );
-       m_wind = m_wind.ScalarMult( speedKts );
-       
-       // At this point the wind direction is 'from where the wind is blowing'.
+
+       // The wind direction is 'from where the wind is blowing'.
        // To use it as velocity vector for dynamics calculations 
-       // it's direction needs to be swapped to the opposite to make it indicate 
+       // it's direction is swapped to the opposite to make it indicate 
        // 'where the wind blows'.
-       m_wind = m_wind.ScalarMult( -1.0f );
+       m_wind = WindVector( m_dirFromDegT, speedKts );
        
        // debug draw
        m_vArrows.resize( c_numOfVArrows );
@@ -41,16 +36,16 @@ WV::WV( const Vector3<float>& drawPosition )
    const float WV::GetMaxDriftAngleDeg( float speedKt )
    {
       // 1st way to calc - analiticly
-      return Rad2Deg( atan( ( m_wind.Mag() / speedKt) ));
+      return Rad2Deg( Trig<float>::Atan( ( m_wind.Mag() / speedKt) ));
       // flying 60kt with x wind 1kt the drift angle = 1 DEG
       //return ( m_wind.Mag() / speedKt ) * 60.0f;
    }
  
-   void WV::Draw() const
+   void WV::Draw( LineBatch& batch ) const
    { 
-      m_line.Draw();
+      batch.Add( m_line );
       for( unsigned int i = 0; i < c_numOfVArrows; ++i ) {
-          m_vArrows[i].Draw();
+          m_vArrows[i].Draw( batch );
       }
    }
    
\ No newline at end of file
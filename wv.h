@@ -9,7 +9,9 @@
 #include "quat.h"
 #include "matrix4.h"
 #include "glLine.h"
+#include "lineBatch.h"
 #include "varrow2d.h"
+#include "windVector.h"
 
 using namespace GrapheneMath;
 
@@ -30,7 +32,7 @@ public:
    const Vector3<float> GetWV( void ) const { return m_wind; }  // kts = NM / H
    const float          GetDirFromDegT( void ) const { return m_dirFromDegT; } // kts = NM / H
    const float          GetMaxDriftAngleDeg( float speedKt );
-   void Draw() const;
+   void Draw( LineBatch& batch ) const;
 };
 
 
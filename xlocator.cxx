@@ -72,9 +72,9 @@ void XLocator::SetColor( const Vector3<float> & color )
       }
 }
   
-void XLocator::Draw() const
+void XLocator::Draw( LineBatch& batch ) const
 { 
     for( unsigned int i = 0; i < numOfLines; ++i ) {
-        X[ i ].Draw();
+        batch.Add( X[ i ] );
     }
 }
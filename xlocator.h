@@ -9,6 +9,7 @@
 #include "quat.h"
 #include "matrix4.h"
 #include "glLine.h"
+#include "lineBatch.h"
 
 using namespace GrapheneMath;
 
@@ -32,7 +33,7 @@ public:
   void SetPosition( const Vector3<float>& pos );
   void SetRadius( float radius );
   void SetColor( const Vector3<float>& color );
-  void Draw() const;
+  void Draw( LineBatch& batch ) const;
 };
 
 #endif //__XLOCATOR_H__